@@ -0,0 +1,86 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/allocation_counter.h"
+
+#include <stdlib.h>
+
+#include <new>
+
+namespace dart {
+namespace snapshotter {
+
+static thread_local int64_t thread_allocations = 0;
+static thread_local int64_t thread_bytes = 0;
+
+int64_t AllocationCounter::TotalAllocations() {
+  return thread_allocations;
+}
+
+int64_t AllocationCounter::TotalBytes() {
+  return thread_bytes;
+}
+
+// Counts an allocation of |size| bytes and returns the memory for it, or
+// NULL if there is none.
+static void* CountedMalloc(size_t size) {
+  thread_allocations++;
+  thread_bytes += size;
+  return malloc(size == 0 ? 1 : size);
+}
+
+// Like CountedMalloc, but fails the way the throwing operator new must:
+// it retries through the new handler, and throws std::bad_alloc once there
+// is none.
+static void* CountedAllocate(size_t size) {
+  void* result = CountedMalloc(size);
+  while (result == NULL) {
+    std::new_handler handler = std::get_new_handler();
+    if (handler == NULL) {
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+      throw std::bad_alloc();
+#else
+      FATAL("Out of memory");
+#endif
+    }
+    handler();
+    result = malloc(size == 0 ? 1 : size);
+  }
+  return result;
+}
+
+}  // namespace snapshotter
+}  // namespace dart
+
+void* operator new(size_t size) {
+  return dart::snapshotter::CountedAllocate(size);
+}
+
+void* operator new[](size_t size) {
+  return dart::snapshotter::CountedAllocate(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return dart::snapshotter::CountedMalloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return dart::snapshotter::CountedMalloc(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  free(pointer);
+}
+
+void operator delete(void* pointer, size_t size) noexcept {
+  free(pointer);
+}
+
+void operator delete[](void* pointer, size_t size) noexcept {
+  free(pointer);
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_ALLOCATION_COUNTER_H_
+#define SRC_NATIVE_SNAPSHOTTER_ALLOCATION_COUNTER_H_
+
+#include <stdint.h>
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+
+namespace dart {
+namespace snapshotter {
+
+// Counts the allocations made through the global operator new on the
+// current thread while it is alive. allocation_counter.cc replaces the
+// global operator new and delete, so it is only linked into tests and
+// benchmarks.
+class AllocationCounter {
+ public:
+  AllocationCounter()
+      : start_allocations_(TotalAllocations()),
+        start_bytes_(TotalBytes()) {}
+
+  int64_t allocations() const {
+    return TotalAllocations() - start_allocations_;
+  }
+  int64_t bytes() const { return TotalBytes() - start_bytes_; }
+
+  // The number of allocations and bytes allocated by this thread so far.
+  static int64_t TotalAllocations();
+  static int64_t TotalBytes();
+
+ private:
+  int64_t start_allocations_;
+  int64_t start_bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(AllocationCounter);
+};
+
+// Expects |statement| to allocate at most |budget| times. |budget| is
+// evaluated first, so it cannot depend on what |statement| does.
+#define EXPECT_ALLOCATIONS(budget, statement)                                 \
+  do {                                                                        \
+    const int64_t expect_allocations_budget_ =                                \
+        static_cast<int64_t>(budget);                                         \
+    dart::snapshotter::AllocationCounter expect_allocations_counter_;         \
+    statement;                                                                \
+    EXPECT(expect_allocations_counter_.allocations() <=                       \
+           expect_allocations_budget_);                                       \
+  } while (0)
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_ALLOCATION_COUNTER_H_
@@ -0,0 +1,61 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/allocation_counter.h"
+
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dart {
+namespace snapshotter {
+
+static void AllocateOnThread() {
+  std::vector<int> numbers(100);
+}
+
+void AllocationCounterTests() {
+  AllocationCounter counter;
+  EXPECT_EQ(counter.allocations(), 0);
+  EXPECT_EQ(counter.bytes(), 0);
+
+  int* number = new int(1);
+  EXPECT_EQ(counter.allocations(), 1);
+  EXPECT_EQ(counter.bytes(), static_cast<int64_t>(sizeof(int)));
+  delete number;
+  EXPECT_EQ(counter.allocations(), 1);
+
+  std::vector<char> bytes(1000);
+  EXPECT_EQ(counter.allocations(), 2);
+  EXPECT_EQ(counter.bytes(), static_cast<int64_t>(1000 + sizeof(int)));
+
+  // nests, and ignores other threads
+  {
+    AllocationCounter inner;
+    std::thread thread(AllocateOnThread);
+    thread.join();
+    int64_t thread_allocations = inner.allocations();
+    std::vector<char> more_bytes(10);
+    EXPECT_EQ(inner.allocations(), thread_allocations + 1);
+  }
+
+  int64_t allocations = counter.allocations();
+  int* nothrow_number = new (std::nothrow) int(2);
+  EXPECT(nothrow_number != NULL);
+  EXPECT_EQ(counter.allocations(), allocations + 1);
+  delete nothrow_number;
+
+  EXPECT_ALLOCATIONS(0, bytes[0] = 'a');
+  EXPECT_ALLOCATIONS(1, std::string long_string(100, 'a'));
+}
+
+extern void ExecuteAllocationCounterTests() {
+  AllocationCounterTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
@@ -0,0 +1,144 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_EXTENSION_CLASSIFIER_H_
+#define SRC_NATIVE_SNAPSHOTTER_EXTENSION_CLASSIFIER_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "native/platform/globals.h"
+#include "native/snapshotter/path.h"
+#include "native/snapshotter/path_hash.h"
+
+// Classifies paths by the extension of their basename against a fixed set
+// of extensions, using a perfect hash built by the compiler:
+//
+//   constexpr const char* kExtensions[] = { ".dart", ".so", ".snapshot" };
+//   constexpr auto kClassifier = MakeExtensionClassifier(kExtensions);
+//   int index = kClassifier.Classify(Path::kPosix, "lib/a.dart");  // 0
+//
+// Classifying is one backwards scan to the last '.' of the basename and one
+// table probe, and does not allocate. Extensions are compared byte for byte,
+// and only the final one counts, so "a.dart.js" has the extension ".js".
+
+namespace dart {
+namespace snapshotter {
+
+// Reports a set of extensions for which no perfect hash was found, usually
+// because it has duplicates. When the classifier is constexpr this shows
+// up as a build error pointing at the call.
+void ExtensionClassifierHashNotFound();
+
+// The smallest power of two that is at least |n|.
+constexpr size_t ExtensionTableSize(size_t n) {
+  size_t size = 1;
+  while (size < n) size <<= 1;
+  return size;
+}
+
+template <size_t kNumExtensions>
+class ExtensionClassifier {
+ public:
+  static const int kNoMatch = -1;
+
+  // |extensions| include their leading '.', and must outlive the classifier.
+  constexpr explicit ExtensionClassifier(
+      const char* const (&extensions)[kNumExtensions])
+      : extensions_(), lengths_(), seed_(0), table_() {
+    static_assert(kNumExtensions > 0 && kNumExtensions < 255,
+                  "ExtensionClassifier needs 1 to 254 extensions");
+    for (size_t i = 0; i < kNumExtensions; i++) {
+      extensions_[i] = extensions[i];
+      size_t length = 0;
+      while (extensions[i][length] != 0) length++;
+      lengths_[i] = length;
+    }
+    for (uint32_t seed = PathHash::kOffsetBasis32;
+         seed < PathHash::kOffsetBasis32 + kMaxSeeds; seed++) {
+      if (TryBuild(seed)) return;
+    }
+    ExtensionClassifierHashNotFound();
+  }
+
+  // Returns the index of |extension|, including its '.', in the set, or
+  // kNoMatch.
+  constexpr int Find(const char* extension, size_t length) const {
+    uint8_t entry =
+        table_[PathHash::Fnv1a32(extension, length, seed_) & (kTableSize - 1)];
+    if (entry == 0) return kNoMatch;
+    size_t index = entry - 1;
+    if (lengths_[index] != length) return kNoMatch;
+    for (size_t i = 0; i < length; i++) {
+      if (extensions_[index][i] != extension[i]) return kNoMatch;
+    }
+    return static_cast<int>(index);
+  }
+
+  // Returns the index of the extension of the basename of |data|, in the
+  // style of |path|, or kNoMatch. Trailing separators are ignored, and a
+  // basename starting with its only '.', like ".packages", has no
+  // extension.
+  int Classify(const Path& path, const char* data, size_t length) const {
+    const PathStyle& style = path.style();
+    size_t root_length = style.RootLength(data, length);
+    size_t end = length;
+    while (end > root_length && style.IsSeparator(data[end - 1])) end--;
+    size_t dot = end;
+    while (dot > root_length) {
+      char c = data[dot - 1];
+      if (c == '.') break;
+      if (style.IsSeparator(c) || end - dot >= kMaxLength) return kNoMatch;
+      dot--;
+    }
+    if (dot <= root_length + 1 || style.IsSeparator(data[dot - 2])) {
+      return kNoMatch;
+    }
+    return Find(data + dot - 1, end - dot + 1);
+  }
+  int Classify(const Path& path, const std::string& data) const {
+    return Classify(path, data.data(), data.length());
+  }
+
+ private:
+  static const uint32_t kMaxSeeds = 1 << 16;
+  // The longest extension allowed, including its '.'.
+  static const size_t kMaxLength = 32;
+
+  // At most half full, so that a perfect seed is quick to find.
+  static const size_t kTableSize = ExtensionTableSize(2 * kNumExtensions);
+
+  // Fills the table using |seed| and returns true if no two extensions
+  // collide.
+  constexpr bool TryBuild(uint32_t seed) {
+    for (size_t i = 0; i < kTableSize; i++) table_[i] = 0;
+    for (size_t i = 0; i < kNumExtensions; i++) {
+      if (lengths_[i] > kMaxLength) ExtensionClassifierHashNotFound();
+      size_t slot = PathHash::Fnv1a32(extensions_[i], lengths_[i], seed) &
+          (kTableSize - 1);
+      if (table_[slot] != 0) return false;
+      table_[slot] = static_cast<uint8_t>(i + 1);
+    }
+    seed_ = seed;
+    return true;
+  }
+
+  const char* extensions_[kNumExtensions];
+  size_t lengths_[kNumExtensions];
+  uint32_t seed_;
+  // Each slot holds one more than the index of its extension, or zero.
+  uint8_t table_[kTableSize];
+};
+
+template <size_t kNumExtensions>
+constexpr ExtensionClassifier<kNumExtensions> MakeExtensionClassifier(
+    const char* const (&extensions)[kNumExtensions]) {
+  return ExtensionClassifier<kNumExtensions>(extensions);
+}
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_EXTENSION_CLASSIFIER_H_
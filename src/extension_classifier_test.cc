@@ -0,0 +1,83 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include <string.h>
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/allocation_counter.h"
+#include "native/snapshotter/extension_classifier.h"
+#include "native/snapshotter/path.h"
+
+namespace dart {
+namespace snapshotter {
+
+static constexpr const char* kExtensions[] = {
+  ".dart", ".so", ".cc", ".h", ".snapshot", ".dill", ".js", ".json", ".yaml",
+  ".a", ".dylib", ".dll", ".exe", ".packages",
+};
+static constexpr auto kClassifier = MakeExtensionClassifier(kExtensions);
+
+// These are evaluated by the compiler; the test passes by compiling.
+static_assert(kClassifier.Find(".dart", 5) == 0, "");
+static_assert(kClassifier.Find(".snapshot", 9) == 4, "");
+static_assert(kClassifier.Find(".packages", 9) == 13, "");
+static_assert(kClassifier.Find(".dar", 4) == -1, "");
+static_assert(kClassifier.Find(".DART", 5) == -1, "");
+static_assert(kClassifier.Find("", 0) == -1, "");
+
+static int Classify(const Path& path, const char* data) {
+  return kClassifier.Classify(path, data, strlen(data));
+}
+
+void ExtensionClassifierPosixTests() {
+  const Path& path = Path::kPosix;
+  for (size_t i = 0; i < ARRAY_SIZE(kExtensions); i++) {
+    std::string name = std::string("lib/src/file") + kExtensions[i];
+    EXPECT_EQ(Classify(path, name.c_str()), static_cast<int>(i));
+  }
+  EXPECT_EQ(Classify(path, "a.dart"), 0);
+  EXPECT_EQ(Classify(path, "/a/b.c/d.so"), 1);
+  EXPECT_EQ(Classify(path, "a.dart/"), 0);
+  EXPECT_EQ(Classify(path, "a.dart.js"), 6);
+  EXPECT_EQ(Classify(path, "a.js.dart"), 0);
+  EXPECT_EQ(Classify(path, "a/..dart"), 0);
+
+  EXPECT_EQ(Classify(path, ""), -1);
+  EXPECT_EQ(Classify(path, "/"), -1);
+  EXPECT_EQ(Classify(path, "dart"), -1);
+  EXPECT_EQ(Classify(path, "a."), -1);
+  EXPECT_EQ(Classify(path, "a.Dart"), -1);
+  EXPECT_EQ(Classify(path, "a.darts"), -1);
+  EXPECT_EQ(Classify(path, "a.dart/b"), -1);
+  EXPECT_EQ(Classify(path, "a.b\\c"), -1);
+  EXPECT_EQ(Classify(path, ".packages"), -1);
+  EXPECT_EQ(Classify(path, "a/.packages"), -1);
+  EXPECT_EQ(Classify(path, "a/b.packages"), 13);
+  std::string long_extension = "a." + std::string(100, 'x');
+  EXPECT_EQ(Classify(path, long_extension.c_str()), -1);
+
+  int index = 0;
+  std::string name = "/very/long/path/to/some/library/file.snapshot";
+  EXPECT_ALLOCATIONS(0, index = kClassifier.Classify(path, name));
+  EXPECT_EQ(index, 4);
+}
+
+void ExtensionClassifierOtherStyleTests() {
+  EXPECT_EQ(Classify(Path::kWindows, "C:\\a\\b.dll"), 11);
+  EXPECT_EQ(Classify(Path::kWindows, "C:/a/b.exe\\"), 12);
+  EXPECT_EQ(Classify(Path::kWindows, "a.dart\\b"), -1);
+  EXPECT_EQ(Classify(Path::kWindows, "a\\.packages"), -1);
+  EXPECT_EQ(Classify(Path::kUrl, "http://dartlang.org/a.dart"), 0);
+  EXPECT_EQ(Classify(Path::kUrl, "http://dartlang.so"), -1);
+  EXPECT_EQ(Classify(Path::kUrl, "package:a/b.json"), 7);
+}
+
+extern void ExecuteExtensionClassifierTests() {
+  ExtensionClassifierPosixTests();
+  ExtensionClassifierOtherStyleTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
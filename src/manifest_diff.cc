@@ -0,0 +1,286 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/manifest_diff.h"
+
+#include "native/platform/assert.h"
+#include "native/snapshotter/path_order.h"
+#include "native/snapshotter/path_parallel.h"
+#include "native/snapshotter/path_simd.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace dart {
+namespace snapshotter {
+
+// Large manifests are merged in ranges of about this many paths. Smaller
+// ranges are not worth handing to another thread.
+static const size_t kMinPathsPerChunk = 16384;
+
+// Compares the components of |a| and |b| that start at |start|, where
+// both have the same bytes before it, ending in a separator past their
+// roots. Orders like PathOrder::Compare.
+static int CompareFrom(const PathStyle& style,
+                       const std::string& a,
+                       const std::string& b,
+                       size_t start) {
+  size_t i = start;
+  size_t j = start;
+  while (true) {
+    while (i < a.length() && style.IsSeparator(a[i])) i++;
+    while (j < b.length() && style.IsSeparator(b[j])) j++;
+    if (i == a.length() || j == b.length()) {
+      return static_cast<int>(i < a.length()) -
+          static_cast<int>(j < b.length());
+    }
+    size_t a_end = i;
+    while (a_end < a.length() && !style.IsSeparator(a[a_end])) a_end++;
+    size_t b_end = j;
+    while (b_end < b.length() && !style.IsSeparator(b[b_end])) b_end++;
+    size_t a_length = a_end - i;
+    size_t b_length = b_end - j;
+    int result = memcmp(a.data() + i, b.data() + j,
+                        std::min(a_length, b_length));
+    if (result != 0) return result;
+    if (a_length != b_length) return a_length < b_length ? -1 : 1;
+    i = a_end;
+    j = b_end;
+  }
+}
+
+static int Compare(const Path& path,
+                   const std::string& a,
+                   const std::string& b) {
+  const PathStyle& style = path.style();
+  size_t length = std::min(a.length(), b.length());
+  size_t prefix = PathSimd::CommonPrefixLength(a.data(), b.data(), length,
+                                               false);
+  if (prefix == length && a.length() == b.length()) return 0;
+  // Back up to the start of a component, past both roots.
+  while (prefix > 0 && !style.IsSeparator(a[prefix - 1])) prefix--;
+  if (prefix == 0 || prefix < style.RootLength(a) ||
+      prefix < style.RootLength(b)) {
+    return PathOrder::Compare(path, a, b);
+  }
+  return CompareFrom(style, a, b, prefix);
+}
+
+static void DiffRange(const Path& path,
+                      const std::vector<std::string>& old_paths,
+                      size_t old_start,
+                      size_t old_end,
+                      const std::vector<std::string>& new_paths,
+                      size_t new_start,
+                      size_t new_end,
+                      ManifestDiffVisitor* visitor) {
+  size_t i = old_start;
+  size_t j = new_start;
+  while (i < old_end && j < new_end) {
+    int result = Compare(path, old_paths[i], new_paths[j]);
+    if (result == 0) {
+      visitor->Unchanged(i++, j++);
+    } else if (result < 0) {
+      visitor->Removed(i++);
+    } else {
+      visitor->Added(j++);
+    }
+  }
+  for (; i < old_end; i++) visitor->Removed(i);
+  for (; j < new_end; j++) visitor->Added(j);
+}
+
+namespace {
+
+// Holds the entries of one range until they can be passed on in order.
+class BufferingVisitor : public ManifestDiffVisitor {
+ public:
+  BufferingVisitor() {}
+
+  virtual void Removed(size_t old_index) {
+    Add(kRemoved, old_index, 0);
+  }
+  virtual void Added(size_t new_index) {
+    Add(kAdded, 0, new_index);
+  }
+  virtual void Unchanged(size_t old_index, size_t new_index) {
+    Add(kUnchanged, old_index, new_index);
+  }
+
+  void Replay(ManifestDiffVisitor* visitor) const {
+    for (size_t i = 0; i < entries_.size(); i++) {
+      const Entry& entry = entries_[i];
+      switch (entry.kind) {
+        case kRemoved:
+          visitor->Removed(entry.old_index);
+          break;
+        case kAdded:
+          visitor->Added(entry.new_index);
+          break;
+        case kUnchanged:
+          visitor->Unchanged(entry.old_index, entry.new_index);
+          break;
+      }
+    }
+  }
+
+ private:
+  enum Kind { kRemoved, kAdded, kUnchanged };
+
+  struct Entry {
+    Kind kind;
+    size_t old_index;
+    size_t new_index;
+  };
+
+  void Add(Kind kind, size_t old_index, size_t new_index) {
+    Entry entry;
+    entry.kind = kind;
+    entry.old_index = old_index;
+    entry.new_index = new_index;
+    entries_.push_back(entry);
+  }
+
+  std::vector<Entry> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(BufferingVisitor);
+};
+
+// Merges the ranges of a large diff on worker threads, and passes their
+// entries on in order on the calling thread. Workers stay at most
+// |window| ranges ahead of the range being passed on, so only that many
+// are buffered at a time.
+class ParallelDiff {
+ public:
+  ParallelDiff(const Path& path,
+               const std::vector<std::string>& old_paths,
+               const std::vector<std::string>& new_paths,
+               const std::vector<size_t>& old_bounds,
+               const std::vector<size_t>& new_bounds,
+               size_t window)
+      : path_(path),
+        old_paths_(old_paths),
+        new_paths_(new_paths),
+        old_bounds_(old_bounds),
+        new_bounds_(new_bounds),
+        num_chunks_(old_bounds.size() - 1),
+        window_(window),
+        results_(num_chunks_),
+        next_(0),
+        passed_on_(0) {}
+
+  void Run(ManifestDiffVisitor* visitor, size_t num_threads) {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_threads; i++) {
+      threads.push_back(std::thread(&ParallelDiff::Work, this));
+    }
+    for (size_t i = 0; i < num_chunks_; i++) {
+      std::unique_ptr<BufferingVisitor> entries;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (results_[i].get() == NULL) merged_.wait(lock);
+        entries = std::move(results_[i]);
+        passed_on_ = i + 1;
+      }
+      space_.notify_all();
+      entries->Replay(visitor);
+    }
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+  }
+
+ private:
+  void Work() {
+    while (true) {
+      size_t chunk;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (next_ < num_chunks_ && next_ >= passed_on_ + window_) {
+          space_.wait(lock);
+        }
+        if (next_ == num_chunks_) return;
+        chunk = next_++;
+      }
+      std::unique_ptr<BufferingVisitor> entries(new BufferingVisitor());
+      DiffRange(path_, old_paths_, old_bounds_[chunk], old_bounds_[chunk + 1],
+                new_paths_, new_bounds_[chunk], new_bounds_[chunk + 1],
+                entries.get());
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        results_[chunk] = std::move(entries);
+      }
+      merged_.notify_one();
+    }
+  }
+
+  const Path& path_;
+  const std::vector<std::string>& old_paths_;
+  const std::vector<std::string>& new_paths_;
+  const std::vector<size_t>& old_bounds_;
+  const std::vector<size_t>& new_bounds_;
+  const size_t num_chunks_;
+  const size_t window_;
+
+  std::mutex mutex_;
+  // Signaled when a range has been merged.
+  std::condition_variable merged_;
+  // Signaled when a range has been passed on.
+  std::condition_variable space_;
+  std::vector<std::unique_ptr<BufferingVisitor> > results_;
+  // The next range to merge.
+  size_t next_;
+  // The number of ranges passed on.
+  size_t passed_on_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelDiff);
+};
+
+}  // namespace
+
+void ManifestDiff::Diff(const Path& path,
+                        const std::vector<std::string>& old_paths,
+                        const std::vector<std::string>& new_paths,
+                        ManifestDiffVisitor* visitor,
+                        int num_threads) {
+  size_t workers = PathParallel::NumThreads(num_threads);
+  size_t num_chunks =
+      (old_paths.size() + new_paths.size()) / kMinPathsPerChunk;
+  if (num_chunks <= 1 || workers == 1) {
+    DiffRange(path, old_paths, 0, old_paths.size(), new_paths, 0,
+              new_paths.size(), visitor);
+    return;
+  }
+
+  // Cut both manifests before evenly spaced keys taken from the larger one,
+  // so that each range of the old manifest lines up with a range of the
+  // new one.
+  const std::vector<std::string>& keys =
+      old_paths.size() >= new_paths.size() ? old_paths : new_paths;
+  PathOrder::Less less(path);
+  std::vector<size_t> old_bounds(num_chunks + 1);
+  std::vector<size_t> new_bounds(num_chunks + 1);
+  old_bounds[0] = 0;
+  new_bounds[0] = 0;
+  old_bounds[num_chunks] = old_paths.size();
+  new_bounds[num_chunks] = new_paths.size();
+  for (size_t i = 1; i < num_chunks; i++) {
+    const std::string& key = keys[keys.size() * i / num_chunks];
+    old_bounds[i] = std::lower_bound(old_paths.begin(), old_paths.end(), key,
+                                     less) - old_paths.begin();
+    new_bounds[i] = std::lower_bound(new_paths.begin(), new_paths.end(), key,
+                                     less) - new_paths.begin();
+  }
+
+  workers = std::min(workers, num_chunks);
+  ParallelDiff diff(path, old_paths, new_paths, old_bounds, new_bounds,
+                    2 * workers);
+  diff.Run(visitor, workers);
+}
+
+}  // namespace snapshotter
+}  // namespace dart
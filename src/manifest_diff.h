@@ -0,0 +1,57 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_MANIFEST_DIFF_H_
+#define SRC_NATIVE_SNAPSHOTTER_MANIFEST_DIFF_H_
+
+#include <string>
+#include <vector>
+
+#include "native/platform/globals.h"
+#include "native/snapshotter/path.h"
+
+namespace dart {
+namespace snapshotter {
+
+// Receives the entries of a manifest diff, in PathOrder.
+class ManifestDiffVisitor {
+ public:
+  virtual ~ManifestDiffVisitor() {}
+
+  // |old_index| and |new_index| index into the manifests passed to
+  // ManifestDiff::Diff.
+  virtual void Removed(size_t old_index) = 0;
+  virtual void Added(size_t new_index) = 0;
+  virtual void Unchanged(size_t old_index, size_t new_index) = 0;
+};
+
+// Compares two snapshot manifests: lists of normalized paths, without
+// duplicates, sorted with PathOrder.
+class ManifestDiff {
+ public:
+  // Merges |old_paths| and |new_paths|, reporting each path to |visitor| as
+  // removed, added or unchanged, in order. Byte for byte equal paths are
+  // matched with one SIMD comparison, and otherwise the leading directories
+  // two paths share are skipped before they are compared component by
+  // component.
+  //
+  // Large manifests are cut at the same keys into ranges that are merged
+  // on up to |num_threads| threads, or one per core if |num_threads| is
+  // zero. The entries of a range are passed to |visitor| on the calling
+  // thread as soon as it and every range before it are merged, and at most
+  // two ranges per thread are buffered at a time.
+  static void Diff(const Path& path,
+                   const std::vector<std::string>& old_paths,
+                   const std::vector<std::string>& new_paths,
+                   ManifestDiffVisitor* visitor,
+                   int num_threads = 0);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(ManifestDiff);
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_MANIFEST_DIFF_H_
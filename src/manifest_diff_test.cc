@@ -0,0 +1,157 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/manifest_diff.h"
+#include "native/snapshotter/path.h"
+#include "native/snapshotter/path_order.h"
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+
+namespace dart {
+namespace snapshotter {
+
+// Records the diff as "-old", "+new" and "=both" lines.
+class RecordingVisitor : public ManifestDiffVisitor {
+ public:
+  RecordingVisitor(const std::vector<std::string>& old_paths,
+                   const std::vector<std::string>& new_paths)
+      : old_paths_(old_paths), new_paths_(new_paths), in_order_(true) {}
+
+  virtual void Removed(size_t old_index) {
+    Record("-" + old_paths_[old_index]);
+  }
+  virtual void Added(size_t new_index) {
+    Record("+" + new_paths_[new_index]);
+  }
+  virtual void Unchanged(size_t old_index, size_t new_index) {
+    if (old_paths_[old_index] != new_paths_[new_index]) in_order_ = false;
+    Record("=" + old_paths_[old_index]);
+  }
+
+  const std::vector<std::string>& lines() const { return lines_; }
+  bool in_order() const { return in_order_; }
+
+ private:
+  void Record(const std::string& line) {
+    if (!lines_.empty() &&
+        PathOrder::Compare(Path::kPosix, lines_.back().substr(1),
+                           line.substr(1)) >= 0) {
+      in_order_ = false;
+    }
+    lines_.push_back(line);
+  }
+
+  const std::vector<std::string>& old_paths_;
+  const std::vector<std::string>& new_paths_;
+  std::vector<std::string> lines_;
+  bool in_order_;
+};
+
+static std::vector<std::string> Diff(const Path& path,
+                                     const std::vector<std::string>& a,
+                                     const std::vector<std::string>& b) {
+  RecordingVisitor visitor(a, b);
+  ManifestDiff::Diff(path, a, b, &visitor);
+  return visitor.lines();
+}
+
+void ManifestDiffBasicTests() {
+  const Path& path = Path::kPosix;
+  std::vector<std::string> a;
+  a.push_back("/a");
+  a.push_back("/a/b");
+  a.push_back("/a/b/c");
+  a.push_back("/a/bc");
+  a.push_back("/a-b");
+  a.push_back("lib");
+  std::vector<std::string> b;
+  b.push_back("/a/b");
+  b.push_back("/a/b/d");
+  b.push_back("/a/bc");
+  b.push_back("/a-b");
+  b.push_back("/b");
+  std::vector<std::string> lines = Diff(path, a, b);
+  EXPECT_EQ(lines.size(), 8u);
+  EXPECT_EQ(lines[0], "-/a");
+  EXPECT_EQ(lines[1], "=/a/b");
+  EXPECT_EQ(lines[2], "-/a/b/c");
+  EXPECT_EQ(lines[3], "+/a/b/d");
+  EXPECT_EQ(lines[4], "=/a/bc");
+  EXPECT_EQ(lines[5], "=/a-b");
+  EXPECT_EQ(lines[6], "+/b");
+  EXPECT_EQ(lines[7], "-lib");
+
+  std::vector<std::string> empty;
+  EXPECT_EQ(Diff(path, empty, empty).size(), 0u);
+  EXPECT_EQ(Diff(path, a, empty).size(), a.size());
+  EXPECT_EQ(Diff(path, empty, b)[0], "+/a/b");
+
+  // Shared prefixes that end inside a root are compared in full.
+  std::vector<std::string> shares;
+  shares.push_back("\\\\server\\other\\a");
+  shares.push_back("\\\\server\\share\\a");
+  std::vector<std::string> share;
+  share.push_back("\\\\server\\share\\a");
+  lines = Diff(Path::kWindows, shares, share);
+  EXPECT_EQ(lines.size(), 2u);
+  EXPECT_EQ(lines[0], "-\\\\server\\other\\a");
+  EXPECT_EQ(lines[1], "=\\\\server\\share\\a");
+}
+
+static std::vector<std::string> MakeManifest(int count, int seed) {
+  std::vector<std::string> paths;
+  for (int i = 0; i < count; i++) {
+    if ((i * 31 + seed) % 7 == 0) continue;
+    std::stringstream path;
+    path << "/src/pkg" << (i % 37) << "/lib" << (i % 3 ? "/" : "-")
+         << "file" << (i * 7919 % 4093) << ".dart";
+    paths.push_back(path.str());
+  }
+  PathOrder::Sort(Path::kPosix, &paths);
+  paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+  return paths;
+}
+
+void ManifestDiffLargeTests() {
+  const Path& path = Path::kPosix;
+  std::vector<std::string> a = MakeManifest(60000, 1);
+  std::vector<std::string> b = MakeManifest(60000, 3);
+  std::set<std::string> old_set(a.begin(), a.end());
+  std::set<std::string> new_set(b.begin(), b.end());
+  size_t removed = 0;
+  size_t added = 0;
+  size_t unchanged = 0;
+  for (size_t i = 0; i < a.size(); i++) {
+    if (new_set.count(a[i]) == 0) removed++; else unchanged++;
+  }
+  for (size_t i = 0; i < b.size(); i++) {
+    if (old_set.count(b[i]) == 0) added++;
+  }
+
+  for (int threads = 1; threads <= 4; threads *= 2) {
+    RecordingVisitor visitor(a, b);
+    ManifestDiff::Diff(path, a, b, &visitor, threads);
+    EXPECT(visitor.in_order());
+    size_t counts[3] = { 0, 0, 0 };
+    for (size_t i = 0; i < visitor.lines().size(); i++) {
+      char kind = visitor.lines()[i][0];
+      counts[kind == '-' ? 0 : (kind == '+' ? 1 : 2)]++;
+    }
+    EXPECT_EQ(counts[0], removed);
+    EXPECT_EQ(counts[1], added);
+    EXPECT_EQ(counts[2], unchanged);
+  }
+}
+
+extern void ExecuteManifestDiffTests() {
+  ManifestDiffBasicTests();
+  ManifestDiffLargeTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
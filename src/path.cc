@@ -5,6 +5,12 @@
 #include "native/snapshotter/path.h"
 
 #include "native/platform/assert.h"
+#include "native/snapshotter/path_parallel.h"
+#include "native/snapshotter/path_simd.h"
+#include "native/snapshotter/path_trace.h"
+#include "native/snapshotter/static_path.h"
+
+#include <string.h>
 
 #include <algorithm>
 #include <sstream>
@@ -19,15 +25,14 @@ std::string PathStyle::GetRoot(const std::string& path) const {
   return IsRootRelative(path) ? path.substr(0, 1) : std::string();
 }
 
-size_t PosixPathStyle::RootLength(const std::string& path) const {
-  if (path.find("/") == 0) {
-    return 1;
-  }
-  return 0;
+// The root rules of the Posix and URL styles live in static_path.h, so that
+// the compile-time paths follow them too.
+size_t PosixPathStyle::RootLength(const char* path, size_t length) const {
+  return StaticPosixStyle::RootLength(path, length);
 }
 
-bool PosixPathStyle::NeedsSeparator(const std::string& path) const {
-  return !path.empty() && !IsSeparator(*path.rbegin());
+bool PosixPathStyle::NeedsSeparator(const char* path, size_t length) const {
+  return StaticPosixStyle::NeedsSeparator(path, length);
 }
 
 static bool IsAlphabetic(char c) {
@@ -35,23 +40,32 @@ static bool IsAlphabetic(char c) {
       (c >= L'a' && c <= L'z');
 }
 
-size_t WindowsPathStyle::RootLength(const std::string& path) const {
-  if (path.empty()) return 0;
+// Returns the index of the first occurrence of |c| in |path| at or after
+// |start|, or std::string::npos.
+static size_t Find(const char* path, size_t length, char c, size_t start) {
+  if (start >= length) return std::string::npos;
+  const void* found = memchr(path + start, c, length - start);
+  if (found == NULL) return std::string::npos;
+  return static_cast<const char*>(found) - path;
+}
+
+size_t WindowsPathStyle::RootLength(const char* path, size_t length) const {
+  if (length == 0) return 0;
   if (path[0] == '/') return 1;
   if (path[0] == '\\') {
-    if (path.length() < 2 || path[1] != '\\') return 1;
+    if (length < 2 || path[1] != '\\') return 1;
     // The path is a network share. Search for up to two '\'s, as they are
     // the server and share - and part of the root part.
-    size_t index = path.find('\\', 2);
+    size_t index = Find(path, length, '\\', 2);
     if (index != std::string::npos) {
-      index = path.find('\\', index + 1);
+      index = Find(path, length, '\\', index + 1);
       if (index != std::string::npos) return index;
     }
-    return path.length();
+    return length;
   }
   // If the path is of the form 'C:/' or 'C:\', with C being any letter, it's
   // a root part.
-  if (path.length() < 3) return 0;
+  if (length < 3) return 0;
   // Check for the letter.
   if (!IsAlphabetic(path[0])) return 0;
   // Check for the ':'.
@@ -62,52 +76,26 @@ size_t WindowsPathStyle::RootLength(const std::string& path) const {
   return 3;
 }
 
-bool WindowsPathStyle::IsRootRelative(const std::string& path) const {
-  return RootLength(path) == 1;
+bool WindowsPathStyle::IsRootRelative(const char* path, size_t length) const {
+  return RootLength(path, length) == 1;
 }
 
-bool WindowsPathStyle::NeedsSeparator(const std::string& path) const {
-  if (path.empty()) return false;
-  return !IsSeparator(*path.rbegin());
+bool WindowsPathStyle::NeedsSeparator(const char* path,
+                                      size_t length) const {
+  if (length == 0) return false;
+  return !IsSeparator(path[length - 1]);
 }
 
-size_t UrlPathStyle::RootLength(const std::string& path) const {
-  if (path.empty()) return 0;
-  if (IsSeparator(path[0])) return 1;
-
-  size_t index = path.find("/");
-  if (index != std::string::npos && path.find("://", index - 1) == index - 1) {
-    // The root part is up until the next '/', or the full path. Skip
-    // '://' and search for '/' after that.
-    index = path.find("/", index + 2);
-    if (index != std::string::npos) return index;
-    return path.length();
-  }
-  index = 0;
-  for (std::string::const_iterator pos = path.begin(); pos != path.end(); ++pos, ++index) {
-    if (*pos == L':') {
-      return index + 1;
-    }
-    if (!IsAlphabetic(*pos)) break;
-  }
-
-  return 0;
+size_t UrlPathStyle::RootLength(const char* path, size_t length) const {
+  return StaticUrlStyle::RootLength(path, length);
 }
 
-bool UrlPathStyle::IsRootRelative(const std::string& path) const {
-  return !path.empty() && IsSeparator(path[0]);
+bool UrlPathStyle::IsRootRelative(const char* path, size_t length) const {
+  return length > 0 && IsSeparator(path[0]);
 }
 
-bool UrlPathStyle::NeedsSeparator(const std::string& path) const {
-  if (path.empty()) return false;
-
-  // A URL that doesn't end in "/" always needs a separator.
-  if (!IsSeparator(*path.rbegin())) return true;
-
-  // A URI that's just "scheme://" needs an extra separator, despite ending
-  // with "/".
-  return path.rfind("://") == path.length() - 3 &&
-      RootLength(path) == path.length();
+bool UrlPathStyle::NeedsSeparator(const char* path, size_t length) const {
+  return StaticUrlStyle::NeedsSeparator(path, length);
 }
 
 const PosixPathStyle Path::kPosixStyle;
@@ -126,32 +114,128 @@ const Path& Path::current() {
 #endif
 }
 
+uint32_t Path::id() const {
+  if (this == &kWindows) return 1;
+  if (this == &kUrl) return 2;
+  return 0;
+}
+
+const Path* Path::FromId(uint32_t id) {
+  switch (id) {
+    case 0: return &kPosix;
+    case 1: return &kWindows;
+    case 2: return &kUrl;
+  }
+  return NULL;
+}
+
 bool Path::IsAbsolute(const std::string& path) const {
+  PathTraceScope trace(kPathIsAbsolute, *this, path);
   return style_.RootLength(path) != 0;
 }
 
 std::string Path::RootPrefix(const std::string& path) const {
+  PathTraceScope trace(kPathRootPrefix, *this, path);
   return path.substr(0, style_.RootLength(path));
 }
 
 std::string Path::Dirname(const std::string& path) const {
-  ParsedPath parsed(path, style_);
+  PathTraceScope trace(kPathDirname, *this, path);
+  // Strip trailing separators, the last component, and the separators
+  // before it, without going into the root.
+  size_t root_length = style_.RootLength(path);
+  size_t end = path.length();
+  while (end > root_length && style_.IsSeparator(path[end - 1])) end--;
+  while (end > root_length && !style_.IsSeparator(path[end - 1])) end--;
+  while (end > root_length && style_.IsSeparator(path[end - 1])) end--;
+  if (end == root_length) {
+    return root_length > 0 ? path.substr(0, root_length) : ".";
+  }
+  return path.substr(0, end);
+}
 
-  parsed.RemoveTrailingSeparators();
-  if (parsed.parts_.empty()) return parsed.root_.empty() ? "." : parsed.root_;
-  if (parsed.parts_.size() == 1) {
-    return parsed.root_.empty() ? "." : parsed.root_;
+bool Path::IsNormalized(const char* path, size_t length) const {
+  PathTraceScope trace(kPathIsNormalized, *this, path, length);
+  if (length == 0) return false;
+  size_t root_length = style_.RootLength(path, length);
+  if (style_.IsWindows() && memchr(path, '/', root_length) != NULL) {
+    return false;
+  }
+  size_t start = root_length;
+  if (start == length) return true;
+  if (root_length > 0 && style_.NeedsSeparator(path, root_length)) {
+    if (path[start] != style_.separator()) return false;
+    start++;
+  }
+  bool leading = root_length == 0;
+  while (true) {
+    size_t end = start;
+    while (end < length && !style_.IsSeparator(path[end])) end++;
+    size_t component_length = end - start;
+    if (component_length == 0) return false;
+    if (component_length == 1 && path[start] == '.') {
+      if (length != 1) return false;
+    } else if (component_length == 2 && path[start] == '.' &&
+               path[start + 1] == '.') {
+      if (!leading) return false;
+    } else {
+      leading = false;
+    }
+    if (end == length) return true;
+    if (path[end] != style_.separator()) return false;
+    start = end + 1;
   }
-  parsed.parts_.pop_back();
-  parsed.separators_.pop_back();
-  parsed.RemoveTrailingSeparators();
-  return parsed.str();
 }
 
 std::string Path::Normalize(const std::string& path) const {
-  ParsedPath parsed(path, style_);
-  parsed.Normalize();
-  return parsed.str();
+  PathTraceScope trace(kPathNormalize, *this, path);
+  if (IsNormalized(path)) return path;
+
+  // Build the result in place. A ".." removes the component before it by
+  // cutting the result back to the last separator, so each byte is written
+  // and scanned over at most once and the work is linear in the input.
+  size_t root_length = style_.RootLength(path);
+  std::string result;
+  result.reserve(path.length() + 1);
+  result.append(path, 0, root_length);
+  if (style_.IsWindows()) {
+    std::replace(result.begin(), result.end(), '/', '\\');
+  }
+  const char separator = style_.separator();
+  bool is_absolute = root_length > 0;
+  bool root_needs_separator =
+      is_absolute && style_.NeedsSeparator(path.data(), root_length);
+  // The number of components after the root, and how many of those are
+  // leading ".."s that can't be removed.
+  size_t depth = 0;
+  size_t leading_doubles = 0;
+
+  PathComponentIterator it(style_, path.data(), path.length());
+  while (it.Next()) {
+    const char* component = it.component();
+    size_t length = it.component_length();
+    if (length == 1 && component[0] == '.') continue;
+    if (length == 2 && component[0] == '.' && component[1] == '.') {
+      if (depth > leading_doubles) {
+        size_t end = result.length();
+        while (end > root_length && result[end - 1] != separator) end--;
+        if (end > root_length) end--;
+        result.resize(end);
+        depth--;
+        continue;
+      }
+      // Backed out past the beginning. Only a relative path keeps the "..".
+      if (is_absolute) continue;
+      leading_doubles++;
+    }
+    if (depth > 0 || root_needs_separator) result.push_back(separator);
+    result.append(component, length);
+    depth++;
+  }
+
+  // If we collapsed down to nothing, do ".".
+  if (result.empty()) result.push_back('.');
+  return result;
 }
 
 std::string Path::Join(const std::string& part0,
@@ -176,6 +260,8 @@ std::string Path::Join(const std::string& part0,
 }
 
 std::string Path::JoinAll(const std::vector<std::string>& parts) const {
+  PathTraceScope trace(kPathJoinAll, *this,
+                       parts.empty() ? NULL : &parts[0], parts.size());
   std::stringstream buffer;
   bool needs_separator = false;
   bool is_absolute_and_not_root_relative = false;
@@ -217,19 +303,324 @@ std::string Path::JoinAll(const std::vector<std::string>& parts) const {
   return buffer.str();
 }
 
-bool IsEmpty(const std::string& str) { return str.empty(); }
-
 std::vector<std::string> Path::Split(const std::string& path) const {
-  ParsedPath parsed(path, style_);
-  // Filter out empty parts that exist due to multiple separators in a row.
-  std::vector<std::string>::iterator end = std::remove_if(parsed.parts_.begin(),
-                                                          parsed.parts_.end(),
-                                                          IsEmpty);
-  parsed.parts_.resize(end - parsed.parts_.begin());
+  PathTraceScope trace(kPathSplit, *this, path);
+  PathComponentIterator counter(style_, path.data(), path.length());
+  size_t count = counter.root_length() > 0 ? 1 : 0;
+  while (counter.Next()) count++;
+
+  std::vector<std::string> parts;
+  parts.reserve(count);
+  PathComponentIterator it(style_, path.data(), path.length());
+  if (it.root_length() > 0) parts.push_back(path.substr(0, it.root_length()));
+  while (it.Next()) {
+    parts.push_back(std::string(it.component(), it.component_length()));
+  }
+  return parts;
+}
+
+// The fewest paths CommonAncestor scans on a thread of its own.
+static const size_t kMinPathsPerThread = 16384;
+
+// The common prefix of a range of paths with the first path, and whether
+// they all have a root of the same length as the first.
+struct CommonPrefixChunk {
+  size_t prefix;
+  bool same_root;
+};
+
+static void CommonPrefix(const PathStyle* style,
+                         const std::string* first,
+                         const std::string* paths,
+                         size_t begin,
+                         size_t end,
+                         CommonPrefixChunk* chunk) {
+  size_t root_length = style->RootLength(*first);
+  bool either_slash = style->IsWindows();
+  for (size_t i = begin; i < end; i++) {
+    const std::string& path = paths[i];
+    if (style->RootLength(path) != root_length) {
+      chunk->same_root = false;
+      return;
+    }
+    chunk->prefix = PathSimd::CommonPrefixLength(
+        first->data(), path.data(), std::min(chunk->prefix, path.length()),
+        either_slash);
+  }
+}
+
+std::string Path::CommonAncestor(const std::string* paths,
+                                 size_t count) const {
+  PathTraceScope trace(kPathCommonAncestor, *this, paths, count);
+  if (count == 0) return std::string();
+  const std::string& first = paths[0];
+  size_t root_length = style_.RootLength(first);
+
+  size_t num_chunks = PathParallel::NumChunks(count, kMinPathsPerThread, 0);
+  // The last chunk is scanned on this thread, and is the only one for
+  // small inputs, which then need no vector.
+  CommonPrefixChunk last = { first.length(), true };
+  std::vector<CommonPrefixChunk> chunks(num_chunks - 1, last);
+  PathParallel::ForEachChunk(count, num_chunks,
+                             [&](size_t chunk, size_t start, size_t end) {
+    CommonPrefix(&style_, &first, paths, start, end,
+                 chunk < chunks.size() ? &chunks[chunk] : &last);
+  });
+
+  if (!last.same_root) return std::string();
+  size_t end = last.prefix;
+  for (size_t i = 0; i < chunks.size(); i++) {
+    if (!chunks[i].same_root) return std::string();
+    end = std::min(end, chunks[i].prefix);
+  }
+  if (end < root_length) return std::string();
+
+  // Snap the shared prefix back to a component boundary, unless it already
+  // ends one in every path.
+  for (size_t i = 0; i < count; i++) {
+    const std::string& path = paths[i];
+    if (path.length() > end && !style_.IsSeparator(path[end])) {
+      while (end > root_length && !style_.IsSeparator(first[end - 1])) end--;
+      break;
+    }
+  }
+  while (end > root_length && style_.IsSeparator(first[end - 1])) end--;
+  if (end == 0) return ".";
+  return first.substr(0, end);
+}
+
+static char ToLower(char c) {
+  return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+// Compares roots or components of paths in |style|. Windows paths are
+// compared case-insensitively, and any two of their separators match.
+static bool SameName(const PathStyle& style,
+                     const char* a,
+                     size_t a_length,
+                     const char* b,
+                     size_t b_length) {
+  if (a_length != b_length) return false;
+  if (!style.IsWindows()) return memcmp(a, b, a_length) == 0;
+  for (size_t i = 0; i < a_length; i++) {
+    if (ToLower(a[i]) == ToLower(b[i])) continue;
+    if (style.IsSeparator(a[i]) && style.IsSeparator(b[i])) continue;
+    return false;
+  }
+  return true;
+}
+
+static bool IsDot(PathComponentIterator* it) {
+  return it->component_length() == 1 && it->component()[0] == '.';
+}
+
+static bool IsDotDot(PathComponentIterator* it) {
+  return it->component_length() == 2 && it->component()[0] == '.' &&
+      it->component()[1] == '.';
+}
+
+// Advances |it| to its next component other than ".".
+static bool NextName(PathComponentIterator* it) {
+  while (it->Next()) {
+    if (!IsDot(it)) return true;
+  }
+  return false;
+}
+
+bool Path::IsWithin(const std::string& base, const std::string& path) const {
+  PathTraceScope trace(kPathIsWithin, *this, base, path);
+  PathComponentIterator base_it(style_, base.data(), base.length());
+  PathComponentIterator path_it(style_, path.data(), path.length());
+  if (path_it.root_length() > 0) {
+    // |path| replaces |base|, so it has to repeat it.
+    if (!SameName(style_, base.data(), base_it.root_length(), path.data(),
+                  path_it.root_length())) {
+      return false;
+    }
+    while (NextName(&base_it)) {
+      if (!NextName(&path_it) ||
+          !SameName(style_, base_it.component(), base_it.component_length(),
+                    path_it.component(), path_it.component_length())) {
+        return false;
+      }
+    }
+  }
+  int depth = 0;
+  while (NextName(&path_it)) {
+    if (!IsDotDot(&path_it)) {
+      depth++;
+    } else if (--depth < 0) {
+      return false;
+    }
+  }
+  return depth > 0;
+}
+
+namespace {
+
+// The roots that ConvertTo translates between styles.
+enum RootKind {
+  kNoRoot,         // "a"
+  kAbsoluteRoot,   // "/a", "file:///a"
+  kRelativeRoot,   // "\a" in Windows style, "/a" in URL style
+  kDriveRoot,      // "C:\a", "/C:/a", "file:///C:/a"
+  kShareRoot,      // "\\server\a", "//server/a", "file://server/a"
+  kOtherRoot,      // "http://dartlang.org/a"
+};
+
+struct ConvertedRoot {
+  RootKind kind;
+  char drive;
+  const char* host;
+  size_t host_length;
+  // Where the rest of the path starts.
+  size_t rest;
+};
+
+}  // namespace
+
+// Returns true if |path|[start..] starts with a drive letter, as in "C:" or
+// "C:/a".
+static bool HasDrive(const char* path, size_t length, size_t start) {
+  return length - start >= 2 && IsAlphabetic(path[start]) &&
+      path[start + 1] == ':' &&
+      (length - start == 2 || path[start + 2] == '/');
+}
+
+static ConvertedRoot ParseRoot(const Path& style,
+                               const char* path,
+                               size_t length) {
+  ConvertedRoot root = { kNoRoot, 0, NULL, 0, 0 };
+  size_t root_length = style.style().RootLength(path, length);
+  if (root_length == 0) return root;
+  root.rest = root_length;
+  if (&style == &Path::kWindows) {
+    if (root_length == 1) {
+      root.kind = kRelativeRoot;
+    } else if (path[1] == '\\') {
+      root.kind = kShareRoot;
+      root.host = path + 2;
+      root.rest = Find(path, root_length, '\\', 2);
+      if (root.rest == std::string::npos) root.rest = root_length;
+      root.host_length = root.rest - 2;
+    } else {
+      root.kind = kDriveRoot;
+      root.drive = path[0];
+      root.rest = 2;
+    }
+    return root;
+  }
 
-  if (!parsed.root_.empty()) parsed.parts_.insert(parsed.parts_.begin(),
-                                                  parsed.root_);
-  return parsed.parts_;
+  // The "/" that a drive letter follows in Posix paths and file URLs.
+  size_t slash = 0;
+  if (&style == &Path::kPosix) {
+    // POSIX leaves the meaning of a leading "//" to the implementation, so
+    // it is free to stand for a share.
+    if (length > 2 && path[1] == '/' && path[2] != '/') {
+      root.kind = kShareRoot;
+      root.host = path + 2;
+      root.rest = Find(path, length, '/', 2);
+      if (root.rest == std::string::npos) root.rest = length;
+      root.host_length = root.rest - 2;
+      return root;
+    }
+    root.kind = kAbsoluteRoot;
+  } else if (root_length == 1) {
+    root.kind = kRelativeRoot;
+    return root;
+  } else if (root_length >= 7 && strncmp(path, "file://", 7) == 0) {
+    if (root_length > 7) {
+      root.kind = kShareRoot;
+      root.host = path + 7;
+      root.host_length = root_length - 7;
+      return root;
+    }
+    root.kind = kAbsoluteRoot;
+    slash = root_length;
+  } else {
+    root.kind = kOtherRoot;
+    return root;
+  }
+  if (slash < length && path[slash] == '/' &&
+      HasDrive(path, length, slash + 1)) {
+    root.kind = kDriveRoot;
+    root.drive = path[slash + 1];
+    root.rest = slash + 3;
+  }
+  return root;
+}
+
+bool Path::ConvertTo(const Path& target,
+                     const char* path,
+                     size_t length,
+                     std::string* result) const {
+  PathTraceScope trace(kPathConvertTo, *this, path, length, &target);
+  result->clear();
+  if (&target == this) {
+    result->assign(path, length);
+    return true;
+  }
+  ConvertedRoot root = ParseRoot(*this, path, length);
+  bool to_windows = &target == &kWindows;
+  bool to_url = &target == &kUrl;
+  char separator = target.style_.separator();
+  result->reserve(length + root.host_length + 8);
+  switch (root.kind) {
+    case kNoRoot:
+      break;
+    case kAbsoluteRoot:
+      if (to_url) result->append("file://");
+      result->push_back(separator);
+      break;
+    case kRelativeRoot:
+      result->push_back(separator);
+      break;
+    case kDriveRoot:
+      if (to_url) result->append("file://");
+      if (!to_windows) result->push_back('/');
+      result->push_back(root.drive);
+      result->push_back(':');
+      result->push_back(separator);
+      break;
+    case kShareRoot:
+      if (to_url) {
+        result->append("file://");
+      } else {
+        result->push_back(separator);
+        result->push_back(separator);
+      }
+      result->append(root.host, root.host_length);
+      result->push_back(separator);
+      break;
+    case kOtherRoot:
+      return false;
+  }
+
+  // Append the rest of the path, without the separators that follow the
+  // root, and swap its separators for those of |target|.
+  size_t rest = root.rest;
+  if (root.kind != kNoRoot) {
+    while (rest < length && style_.IsSeparator(path[rest])) rest++;
+  }
+  size_t start = result->length();
+  result->append(path + rest, length - rest);
+  if (style_.IsWindows() || to_windows) {
+    PathSimd::ReplaceEither(&(*result)[0] + start, length - rest, '/',
+                            style_.separator(), separator);
+  }
+  return true;
+}
+
+void Path::ConvertAllTo(const Path& target,
+                        const std::vector<std::string>& paths,
+                        std::vector<std::string>* results) const {
+  results->resize(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    const std::string& path = paths[i];
+    if (!ConvertTo(target, path.data(), path.length(), &(*results)[i])) {
+      (*results)[i].clear();
+    }
+  }
 }
 
 Path::ParsedPath::ParsedPath(const std::string& before, const PathStyle& style)
@@ -265,62 +656,6 @@ Path::ParsedPath::ParsedPath(const std::string& before, const PathStyle& style)
   }
 }
 
-void Path::ParsedPath::RemoveTrailingSeparators() {
-  while (!parts_.empty() && parts_.back().empty()) {
-    parts_.pop_back();
-    separators_.pop_back();
-  }
-  if (!separators_.empty()) separators_.back() = 0;
-}
-
-void Path::ParsedPath::Normalize() {
-  // Handle '.', '..', and empty parts.
-  size_t leading_doubles = 0;
-  StrList new_parts;
-  for (StrList::iterator part = parts_.begin(); part != parts_.end(); ++part) {
-    if (*part == "." || *part == "") {
-      // Do nothing. Ignore it.
-    } else if (*part == "..") {
-      // Pop the last part off.
-      if (!new_parts.empty()) {
-        new_parts.pop_back();
-      } else {
-        // Backed out past the beginning, so preserve the "..".
-        leading_doubles++;
-      }
-    } else {
-      new_parts.push_back(*part);
-    }
-  }
-
-  // A relative path can back out from the start directory.
-  if (!IsAbsolute()) {
-    for (size_t i = 0; i < leading_doubles; ++i) {
-      new_parts.insert(new_parts.begin(), "..");
-    }
-  }
-
-  // If we collapsed down to nothing, do ".".
-  if (new_parts.empty() && !IsAbsolute()) {
-    new_parts.push_back(".");
-  }
-
-  // Canonicalize separators.
-  std::vector<char> new_separators(new_parts.size(), style_->separator());
-  new_separators.insert(new_separators.begin(),
-      IsAbsolute() && !new_parts.empty() && style_->NeedsSeparator(root_) ?
-      style_->separator() : 0);
-
-  parts_ = new_parts;
-  separators_ = new_separators;
-
-  // Normalize the Windows root if needed.
-  if (!root_.empty() && style_->IsWindows()) {
-    std::replace(root_.begin(), root_.end(), '/', '\\');
-  }
-  RemoveTrailingSeparators();
-}
-
 std::string Path::ParsedPath::str() const {
   std::stringstream strstr;
   if (!root_.empty()) strstr << root_;
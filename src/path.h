@@ -5,10 +5,13 @@
 #ifndef SRC_NATIVE_SNAPSHOTTER_PATH_H_
 #define SRC_NATIVE_SNAPSHOTTER_PATH_H_
 
+#include <stdint.h>
+
 #include <string>
 #include <vector>
 
 #include "native/platform/globals.h"
+#include "native/snapshotter/path_utf16.h"
 
 namespace dart {
 namespace snapshotter {
@@ -18,12 +21,22 @@ class PathStyle {
   virtual ~PathStyle() {}
 
   virtual char separator() const = 0;
-  virtual size_t RootLength(const std::string& path) const = 0;
-  virtual bool IsRootRelative(const std::string& path) const = 0;
+  virtual size_t RootLength(const char* path, size_t length) const = 0;
+  virtual bool IsRootRelative(const char* path, size_t length) const = 0;
   virtual bool IsSeparator(char c) const = 0;
-  virtual bool NeedsSeparator(const std::string& root) const = 0;
+  virtual bool NeedsSeparator(const char* path, size_t length) const = 0;
   virtual bool IsWindows() const = 0;
 
+  size_t RootLength(const std::string& path) const {
+    return RootLength(path.data(), path.length());
+  }
+  bool IsRootRelative(const std::string& path) const {
+    return IsRootRelative(path.data(), path.length());
+  }
+  bool NeedsSeparator(const std::string& path) const {
+    return NeedsSeparator(path.data(), path.length());
+  }
+
   std::string GetRoot(const std::string& path) const;
 
  protected:
@@ -39,10 +52,16 @@ class PosixPathStyle: public PathStyle {
   virtual ~PosixPathStyle() {}
 
   virtual char separator() const { return '/'; }
-  virtual size_t RootLength(const std::string& path) const;
-  virtual bool IsRootRelative(const std::string& path) const { return false; }
+  using PathStyle::RootLength;
+  using PathStyle::IsRootRelative;
+  using PathStyle::NeedsSeparator;
+
+  virtual size_t RootLength(const char* path, size_t length) const;
+  virtual bool IsRootRelative(const char* path, size_t length) const {
+    return false;
+  }
   virtual bool IsSeparator(char c) const { return c == L'/'; }
-  virtual bool NeedsSeparator(const std::string& root) const;
+  virtual bool NeedsSeparator(const char* path, size_t length) const;
   virtual bool IsWindows() const { return false; }
 
  private:
@@ -55,10 +74,14 @@ class WindowsPathStyle: public PathStyle {
   virtual ~WindowsPathStyle() {}
 
   virtual char separator() const { return '\\'; }
-  virtual size_t RootLength(const std::string& path) const;
-  virtual bool IsRootRelative(const std::string& path) const;
+  using PathStyle::RootLength;
+  using PathStyle::IsRootRelative;
+  using PathStyle::NeedsSeparator;
+
+  virtual size_t RootLength(const char* path, size_t length) const;
+  virtual bool IsRootRelative(const char* path, size_t length) const;
   virtual bool IsSeparator(char c) const { return c == L'/' || c == L'\\'; }
-  virtual bool NeedsSeparator(const std::string& root) const;
+  virtual bool NeedsSeparator(const char* path, size_t length) const;
   virtual bool IsWindows() const { return true; }
 
  private:
@@ -71,16 +94,64 @@ class UrlPathStyle: public PathStyle {
   virtual ~UrlPathStyle() {}
 
   virtual char separator() const { return '/'; }
-  virtual size_t RootLength(const std::string& path) const;
-  virtual bool IsRootRelative(const std::string& path) const;
+  using PathStyle::RootLength;
+  using PathStyle::IsRootRelative;
+  using PathStyle::NeedsSeparator;
+
+  virtual size_t RootLength(const char* path, size_t length) const;
+  virtual bool IsRootRelative(const char* path, size_t length) const;
   virtual bool IsSeparator(char c) const { return c == L'/'; }
-  virtual bool NeedsSeparator(const std::string& root) const;
+  virtual bool NeedsSeparator(const char* path, size_t length) const;
   virtual bool IsWindows() const { return false; }
 
  private:
   DISALLOW_COPY_AND_ASSIGN(UrlPathStyle);
 };
 
+// Iterates over the non-empty components that follow the root of a path,
+// without copying them. The path must outlive the iterator.
+class PathComponentIterator {
+ public:
+  PathComponentIterator(const PathStyle& style, const char* path, size_t length)
+      : style_(style),
+        path_(path),
+        length_(length),
+        root_length_(style.RootLength(path, length)),
+        position_(root_length_),
+        start_(0),
+        end_(0) {}
+
+  // Advances to the next component. Returns false when there are none left.
+  bool Next() {
+    while (position_ < length_ && style_.IsSeparator(path_[position_])) {
+      position_++;
+    }
+    if (position_ == length_) return false;
+    start_ = position_;
+    while (position_ < length_ && !style_.IsSeparator(path_[position_])) {
+      position_++;
+    }
+    end_ = position_;
+    return true;
+  }
+
+  size_t root_length() const { return root_length_; }
+  const char* component() const { return path_ + start_; }
+  size_t component_start() const { return start_; }
+  size_t component_length() const { return end_ - start_; }
+
+ private:
+  const PathStyle& style_;
+  const char* path_;
+  size_t length_;
+  size_t root_length_;
+  size_t position_;
+  size_t start_;
+  size_t end_;
+
+  DISALLOW_COPY_AND_ASSIGN(PathComponentIterator);
+};
+
 class Path {
  public:
   static const Path kPosix;
@@ -93,10 +164,27 @@ class Path {
 
   static const Path& current();
 
+  // A stable number for each of kPosix, kWindows and kUrl, for files that
+  // record a style, such as PathIndex and path traces.
+  uint32_t id() const;
+  // Returns the Path whose id() is |id|, or NULL if there is none.
+  static const Path* FromId(uint32_t id);
+
+  const PathStyle& style() const { return style_; }
+
   bool IsAbsolute(const std::string& path) const;
   std::string RootPrefix(const std::string& path) const;
   std::string Dirname(const std::string& path) const;
   std::string Normalize(const std::string& path) const;
+
+  // Returns true if Normalize would return |path| unchanged: it uses only the
+  // style's own separator, once between each component, and has no "." or
+  // ".." components other than leading ".."s in a relative path, or "." on
+  // its own. Does not allocate.
+  bool IsNormalized(const char* path, size_t length) const;
+  bool IsNormalized(const std::string& path) const {
+    return IsNormalized(path.data(), path.length());
+  }
   std::string Join(const std::string& part0,
                    const std::string& part1 = "",
                    const std::string& part2 = "",
@@ -109,6 +197,98 @@ class Path {
   std::string JoinAll(const std::vector<std::string>& parts) const;
   std::vector<std::string> Split(const std::string& path) const;
 
+  // Returns the deepest directory that contains all of |paths|: their
+  // longest common sequence of components, as written. A single path is its
+  // own ancestor. Returns "." for relative paths with no components in
+  // common, and "" if the paths have different roots or |count| is zero.
+  // Large inputs are scanned on several threads.
+  std::string CommonAncestor(const std::string* paths, size_t count) const;
+  std::string CommonAncestor(const std::vector<std::string>& paths) const {
+    return paths.empty() ? std::string() :
+        CommonAncestor(&paths[0], paths.size());
+  }
+
+  // Returns true if |path|, resolved against |base| as Join would, names
+  // something strictly inside |base|. This is decided lexically and without
+  // allocating: |path| has to start with the root and components of |base|,
+  // ignoring "." and redundant separators, and no ".." in the rest of it may
+  // step out of |base|, even if the path later steps back in. Windows paths
+  // are compared case-insensitively.
+  bool IsWithin(const std::string& base, const std::string& path) const;
+
+  // Rewrites |path| in the style of |target|, translating its root and
+  // separators. Posix absolute paths and Windows drive and UNC paths map to
+  // "file:" URLs and back, with a drive "C:\" written as "/C:/" in Posix
+  // style and a share "\\server\" as "//server/". Nothing else is
+  // changed: the path is not normalized and no characters are
+  // percent-encoded or decoded. Returns false, or "", if the root has no
+  // equivalent in |target|, as for "http:" URLs converted to file paths.
+  bool ConvertTo(const Path& target,
+                 const char* path,
+                 size_t length,
+                 std::string* result) const;
+  std::string ConvertTo(const Path& target, const std::string& path) const {
+    std::string result;
+    if (!ConvertTo(target, path.data(), path.length(), &result)) return "";
+    return result;
+  }
+
+  // Converts each of |paths|, storing the results in |results|.
+  void ConvertAllTo(const Path& target,
+                    const std::vector<std::string>& paths,
+                    std::vector<std::string>* results) const;
+
+  // Versions of the above for UTF-16 paths, held in std::u16string or, on
+  // Windows, std::wstring. They transcode to UTF-8 and back with PathUtf16,
+  // which is cheap for paths that are mostly ASCII.
+  template <typename Char>
+  bool IsAbsolute(const std::basic_string<Char>& path) const {
+    return IsAbsolute(PathUtf16::ToUtf8(path));
+  }
+  template <typename Char>
+  std::basic_string<Char> RootPrefix(
+      const std::basic_string<Char>& path) const {
+    return PathUtf16::ToUtf16<Char>(RootPrefix(PathUtf16::ToUtf8(path)));
+  }
+  template <typename Char>
+  std::basic_string<Char> Dirname(const std::basic_string<Char>& path) const {
+    return PathUtf16::ToUtf16<Char>(Dirname(PathUtf16::ToUtf8(path)));
+  }
+  template <typename Char>
+  std::basic_string<Char> Normalize(
+      const std::basic_string<Char>& path) const {
+    return PathUtf16::ToUtf16<Char>(Normalize(PathUtf16::ToUtf8(path)));
+  }
+  template <typename Char>
+  bool IsNormalized(const std::basic_string<Char>& path) const {
+    return IsNormalized(PathUtf16::ToUtf8(path));
+  }
+  template <typename Char>
+  std::basic_string<Char> Join(const std::basic_string<Char>& part0,
+                               const std::basic_string<Char>& part1) const {
+    return PathUtf16::ToUtf16<Char>(
+        Join(PathUtf16::ToUtf8(part0), PathUtf16::ToUtf8(part1)));
+  }
+  template <typename Char>
+  std::basic_string<Char> JoinAll(
+      const std::vector<std::basic_string<Char> >& parts) const {
+    std::vector<std::string> utf8_parts(parts.size());
+    for (size_t i = 0; i < parts.size(); i++) {
+      utf8_parts[i] = PathUtf16::ToUtf8(parts[i]);
+    }
+    return PathUtf16::ToUtf16<Char>(JoinAll(utf8_parts));
+  }
+  template <typename Char>
+  std::vector<std::basic_string<Char> > Split(
+      const std::basic_string<Char>& path) const {
+    std::vector<std::string> utf8_parts = Split(PathUtf16::ToUtf8(path));
+    std::vector<std::basic_string<Char> > parts(utf8_parts.size());
+    for (size_t i = 0; i < parts.size(); i++) {
+      parts[i] = PathUtf16::ToUtf16<Char>(utf8_parts[i]);
+    }
+    return parts;
+  }
+
  private:
   Path(const PathStyle& style) : style_(style) {}
 
@@ -116,8 +296,6 @@ class Path {
    public:
     ParsedPath(const std::string& path, const PathStyle& style);
 
-    void RemoveTrailingSeparators();
-    void Normalize();
     bool IsAbsolute() const { return !root_.empty(); }
 
     std::string str() const;
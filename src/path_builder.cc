@@ -0,0 +1,103 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/path_builder.h"
+
+#include "native/platform/assert.h"
+
+namespace dart {
+namespace snapshotter {
+
+static bool IsDot(const char* component, size_t length) {
+  return length == 1 && component[0] == '.';
+}
+
+static bool IsDoubleDot(const char* component, size_t length) {
+  return length == 2 && component[0] == '.' && component[1] == '.';
+}
+
+PathBuilder::PathBuilder(const Path& path, const std::string& initial)
+    : path_(path),
+      style_(path.style()),
+      root_length_(0),
+      root_needs_separator_(false),
+      leading_doubles_(0) {
+  Reset(initial);
+}
+
+void PathBuilder::Reset(const std::string& path) {
+  buffer_ = path_.Normalize(path);
+  offsets_.clear();
+  leading_doubles_ = 0;
+  root_length_ = style_.RootLength(buffer_);
+  root_needs_separator_ = root_length_ > 0 &&
+      style_.NeedsSeparator(buffer_.data(), root_length_);
+
+  PathComponentIterator it(style_, buffer_.data(), buffer_.length());
+  while (it.Next()) {
+    if (IsDot(it.component(), it.component_length())) continue;
+    if (IsDoubleDot(it.component(), it.component_length())) {
+      leading_doubles_++;
+    }
+    offsets_.push_back(offsets_.empty() ?
+        root_length_ : it.component_start() - 1);
+  }
+}
+
+void PathBuilder::Push(const char* part, size_t length) {
+  if (length == 0) return;
+  if (style_.IsRootRelative(part, length) && root_length_ > 0 &&
+      !style_.IsRootRelative(buffer_)) {
+    // A root-relative part keeps the current root but replaces the rest.
+    Truncate(leading_doubles_);
+    part++;
+    length--;
+  } else if (style_.RootLength(part, length) > 0) {
+    Reset(std::string(part, length));
+    return;
+  }
+
+  size_t start = 0;
+  for (size_t i = 0; i <= length; i++) {
+    if (i == length || style_.IsSeparator(part[i])) {
+      PushComponent(part + start, i - start);
+      start = i + 1;
+    }
+  }
+}
+
+void PathBuilder::PushComponent(const char* component, size_t length) {
+  if (length == 0 || IsDot(component, length)) return;
+  if (IsDoubleDot(component, length)) {
+    if (offsets_.size() > leading_doubles_) {
+      Truncate(offsets_.size() - 1);
+      return;
+    }
+    // Absolute paths can't back out past the root.
+    if (root_length_ > 0) return;
+    leading_doubles_++;
+  }
+
+  if (offsets_.empty()) {
+    // Drop the "." that stands for an empty relative path.
+    buffer_.resize(root_length_);
+    offsets_.push_back(root_length_);
+    if (root_needs_separator_) buffer_.push_back(style_.separator());
+  } else {
+    offsets_.push_back(buffer_.length());
+    buffer_.push_back(style_.separator());
+  }
+  buffer_.append(component, length);
+}
+
+void PathBuilder::Truncate(size_t depth) {
+  ASSERT(depth >= leading_doubles_ && depth <= offsets_.size());
+  if (depth == offsets_.size()) return;
+  buffer_.resize(offsets_[depth]);
+  offsets_.resize(depth);
+  if (buffer_.empty()) buffer_ = ".";
+}
+
+}  // namespace snapshotter
+}  // namespace dart
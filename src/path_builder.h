@@ -0,0 +1,71 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_PATH_BUILDER_H_
+#define SRC_NATIVE_SNAPSHOTTER_PATH_BUILDER_H_
+
+#include <string>
+#include <vector>
+
+#include "native/platform/globals.h"
+#include "native/snapshotter/path.h"
+
+namespace dart {
+namespace snapshotter {
+
+// Maintains a normalized path that can be extended and shortened one
+// component at a time, for walking directory trees without joining and
+// normalizing the full path at every level.
+//
+// After any sequence of operations, str() equals what Path::Normalize
+// returns for the Path::Join of the initial path and every pushed part, with
+// Pop() acting like pushing "..". Each operation costs time proportional to
+// the components it adds or removes, not to the length of the path.
+class PathBuilder {
+ public:
+  PathBuilder(const Path& path, const std::string& initial);
+
+  // Replaces the current path with the normalized form of |path|.
+  void Reset(const std::string& path);
+
+  // Appends |part|, resolving "." and ".." components. An absolute |part|
+  // replaces the current path, as it would in Path::Join.
+  void Push(const char* part, size_t length);
+  void Push(const std::string& part) { Push(part.data(), part.length()); }
+
+  // Moves to the parent directory.
+  void Pop() { PushComponent("..", 2); }
+
+  // The number of components after the root, including leading "..".
+  size_t depth() const { return offsets_.size(); }
+
+  // Removes components until depth() is |depth|, which must not be less than
+  // the number of leading ".." components. Used to return to a directory
+  // after walking below it.
+  void Truncate(size_t depth);
+
+  const std::string& str() const { return buffer_; }
+
+ private:
+  // Appends a single component, which must not contain separators.
+  void PushComponent(const char* component, size_t length);
+
+  const Path& path_;
+  const PathStyle& style_;
+  std::string buffer_;
+  size_t root_length_;
+  bool root_needs_separator_;
+
+  // The offset at which each component, including the separator before it,
+  // starts in |buffer_|.
+  std::vector<size_t> offsets_;
+  size_t leading_doubles_;
+
+  DISALLOW_COPY_AND_ASSIGN(PathBuilder);
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_PATH_BUILDER_H_
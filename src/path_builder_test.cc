@@ -0,0 +1,84 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path.h"
+#include "native/snapshotter/path_builder.h"
+
+namespace dart {
+namespace snapshotter {
+
+static const char* kStarts[] = {
+  "", ".", "..", "a", "a/b", "../a", "/", "/a/b", "C:\\a", "\\\\server\\share",
+  "http://dartlang.org/a", "file:///a",
+};
+
+static const char* kParts[] = {
+  "b", ".", "..", "", "c/d", "../e", "./f/", "g//h", "..\\i", "/j", "\\k",
+  "D:\\l", "http://m.org/n",
+};
+
+// Checks that pushing each part in turn matches joining and normalizing.
+static void CompareWithJoin(const Path& path) {
+  for (size_t s = 0; s < ARRAY_SIZE(kStarts); s++) {
+    for (size_t p = 0; p < ARRAY_SIZE(kParts); p++) {
+      for (size_t q = 0; q < ARRAY_SIZE(kParts); q++) {
+        PathBuilder builder(path, kStarts[s]);
+        EXPECT_EQ(builder.str(), path.Normalize(kStarts[s]));
+        builder.Push(kParts[p]);
+        EXPECT_EQ(builder.str(),
+            path.Normalize(path.Join(kStarts[s], kParts[p])));
+        builder.Push(kParts[q]);
+        EXPECT_EQ(builder.str(),
+            path.Normalize(path.Join(kStarts[s], kParts[p], kParts[q])));
+        builder.Pop();
+        EXPECT_EQ(builder.str(),
+            path.Normalize(path.Join(kStarts[s], kParts[p], kParts[q], "..")));
+      }
+    }
+  }
+}
+
+void PathBuilderJoinTests() {
+  CompareWithJoin(Path::kPosix);
+  CompareWithJoin(Path::kWindows);
+  CompareWithJoin(Path::kUrl);
+}
+
+void PathBuilderWalkTests() {
+  PathBuilder builder(Path::kPosix, "/root/./src/");
+  EXPECT_EQ(builder.str(), "/root/src");
+  EXPECT_EQ(builder.depth(), 2u);
+
+  size_t depth = builder.depth();
+  builder.Push("lib");
+  builder.Push("a.dart");
+  EXPECT_EQ(builder.str(), "/root/src/lib/a.dart");
+  builder.Truncate(depth);
+  EXPECT_EQ(builder.str(), "/root/src");
+  builder.Pop();
+  builder.Pop();
+  builder.Pop();
+  EXPECT_EQ(builder.str(), "/");
+  EXPECT_EQ(builder.depth(), 0u);
+
+  PathBuilder relative(Path::kWindows, "a");
+  relative.Pop();
+  EXPECT_EQ(relative.str(), ".");
+  relative.Pop();
+  EXPECT_EQ(relative.str(), "..");
+  relative.Push("b");
+  EXPECT_EQ(relative.str(), "..\\b");
+  relative.Truncate(1);
+  EXPECT_EQ(relative.str(), "..");
+}
+
+extern void ExecutePathBuilderTests() {
+  PathBuilderJoinTests();
+  PathBuilderWalkTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
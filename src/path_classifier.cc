@@ -0,0 +1,50 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/path_classifier.h"
+
+#include "native/platform/assert.h"
+#include "native/snapshotter/path_simd.h"
+
+namespace dart {
+namespace snapshotter {
+
+const Path& PathClassifier::Classify(const char* path, size_t length) {
+  if (length == 0) return Path::kPosix;
+  if (path[0] == '\\') return Path::kWindows;
+  if (path[0] == '/') return Path::kPosix;
+
+  // A drive root such as "C:\" or "C:/".
+  if (Path::kWindowsStyle.RootLength(path, length) == 3) {
+    return Path::kWindows;
+  }
+  // The URL style takes a letter and a ':' for a scheme, so a drive on its
+  // own has a root of 2. Longer roots are a scheme of two or more letters,
+  // or a scheme followed by "://" and an authority.
+  size_t url_root = Path::kUrlStyle.RootLength(path, length);
+  if (url_root == 2 && length == 2) return Path::kWindows;
+  if (url_root > 2) return Path::kUrl;
+
+  if (PathSimd::Find(path, length, '\\') < length) return Path::kWindows;
+  return Path::kPosix;
+}
+
+void PathClassifier::ClassifyAll(const std::vector<std::string>& paths,
+                                 std::vector<const Path*>* styles) {
+  styles->resize(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    (*styles)[i] = &Classify(paths[i]);
+  }
+}
+
+void PathClassifier::NormalizeAll(const std::vector<std::string>& paths,
+                                  std::vector<std::string>* results) {
+  results->resize(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    (*results)[i] = Classify(paths[i]).Normalize(paths[i]);
+  }
+}
+
+}  // namespace snapshotter
+}  // namespace dart
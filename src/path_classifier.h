@@ -0,0 +1,48 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_PATH_CLASSIFIER_H_
+#define SRC_NATIVE_SNAPSHOTTER_PATH_CLASSIFIER_H_
+
+#include <string>
+#include <vector>
+
+#include "native/platform/globals.h"
+#include "native/snapshotter/path.h"
+
+namespace dart {
+namespace snapshotter {
+
+// Guesses which Path style a path string was written in, for inputs that
+// mix Posix paths, Windows drive and UNC paths, and URLs. The roots are
+// found with the RootLength of the Windows and URL styles.
+//
+//  - "C:", "C:\..." or "C:/..." and anything starting with '\' is Windows.
+//  - "scheme:..." with a scheme of two or more letters, or any
+//    "scheme://...", is a URL.
+//  - Otherwise a path containing a '\' is Windows, and anything else is
+//    Posix.
+class PathClassifier {
+ public:
+  static const Path& Classify(const char* path, size_t length);
+  static const Path& Classify(const std::string& path) {
+    return Classify(path.data(), path.length());
+  }
+
+  // Classifies each of |paths|, storing the results in |styles|.
+  static void ClassifyAll(const std::vector<std::string>& paths,
+                          std::vector<const Path*>* styles);
+
+  // Normalizes each of |paths| with the style it is classified as.
+  static void NormalizeAll(const std::vector<std::string>& paths,
+                           std::vector<std::string>* results);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(PathClassifier);
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_PATH_CLASSIFIER_H_
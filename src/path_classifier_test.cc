@@ -0,0 +1,69 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path.h"
+#include "native/snapshotter/path_classifier.h"
+
+namespace dart {
+namespace snapshotter {
+
+void PathClassifierTests() {
+  EXPECT_EQ(&PathClassifier::Classify(""), &Path::kPosix);
+  EXPECT_EQ(&PathClassifier::Classify("a"), &Path::kPosix);
+  EXPECT_EQ(&PathClassifier::Classify("a/b/c.dart"), &Path::kPosix);
+  EXPECT_EQ(&PathClassifier::Classify("/usr/lib"), &Path::kPosix);
+  EXPECT_EQ(&PathClassifier::Classify("./a:b"), &Path::kPosix);
+  EXPECT_EQ(&PathClassifier::Classify("a/b:c"), &Path::kPosix);
+  EXPECT_EQ(&PathClassifier::Classify("C:a"), &Path::kPosix);
+  EXPECT_EQ(&PathClassifier::Classify("a1:b"), &Path::kPosix);
+
+  EXPECT_EQ(&PathClassifier::Classify("C:"), &Path::kWindows);
+  EXPECT_EQ(&PathClassifier::Classify("C:\\a\\b"), &Path::kWindows);
+  EXPECT_EQ(&PathClassifier::Classify("d:/a/b"), &Path::kWindows);
+  EXPECT_EQ(&PathClassifier::Classify("\\\\server\\share\\a"),
+      &Path::kWindows);
+  EXPECT_EQ(&PathClassifier::Classify("\\a"), &Path::kWindows);
+  EXPECT_EQ(&PathClassifier::Classify("a\\b"), &Path::kWindows);
+  EXPECT_EQ(&PathClassifier::Classify("some/long/relative/path/mixed\\sep"),
+      &Path::kWindows);
+
+  EXPECT_EQ(&PathClassifier::Classify("http://dartlang.org/a"), &Path::kUrl);
+  EXPECT_EQ(&PathClassifier::Classify("file:///a/b"), &Path::kUrl);
+  EXPECT_EQ(&PathClassifier::Classify("package:foo/foo.dart"), &Path::kUrl);
+  EXPECT_EQ(&PathClassifier::Classify("dart:core"), &Path::kUrl);
+  EXPECT_EQ(&PathClassifier::Classify("svn+ssh://host/a"), &Path::kUrl);
+}
+
+void PathClassifierBatchTests() {
+  std::vector<std::string> paths;
+  paths.push_back("a//b/../c");
+  paths.push_back("C:/a/./b");
+  paths.push_back("http://dartlang.org/a/../b");
+  paths.push_back("\\\\server\\share\\..\\a");
+
+  std::vector<const Path*> styles;
+  PathClassifier::ClassifyAll(paths, &styles);
+  EXPECT_EQ(styles.size(), paths.size());
+  EXPECT_EQ(styles[0], &Path::kPosix);
+  EXPECT_EQ(styles[1], &Path::kWindows);
+  EXPECT_EQ(styles[2], &Path::kUrl);
+  EXPECT_EQ(styles[3], &Path::kWindows);
+
+  std::vector<std::string> normalized;
+  PathClassifier::NormalizeAll(paths, &normalized);
+  EXPECT_EQ(normalized[0], "a/c");
+  EXPECT_EQ(normalized[1], "C:\\a\\b");
+  EXPECT_EQ(normalized[2], "http://dartlang.org/b");
+  EXPECT_EQ(normalized[3], "\\\\server\\share\\a");
+}
+
+extern void ExecutePathClassifierTests() {
+  PathClassifierTests();
+  PathClassifierBatchTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
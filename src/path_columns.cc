@@ -0,0 +1,126 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/path_columns.h"
+
+#include "native/platform/assert.h"
+#include "native/snapshotter/path_parallel.h"
+
+#include <string.h>
+
+#include <memory>
+
+namespace dart {
+namespace snapshotter {
+
+// The fewest paths Build splits into columns on a thread of its own.
+static const size_t kMinPathsPerChunk = 4096;
+
+PathColumns::PathColumns() {
+  Clear();
+}
+
+void PathColumns::Clear() {
+  bytes_.clear();
+  component_offsets_.assign(1, 0);
+  path_components_.assign(1, 0);
+  root_lengths_.clear();
+}
+
+std::string PathColumns::ComponentString(size_t index, size_t i) const {
+  size_t length;
+  const char* component = Component(index, i, &length);
+  return std::string(component, length);
+}
+
+std::vector<std::string> PathColumns::Split(size_t index) const {
+  std::vector<std::string> result;
+  size_t count = NumComponents(index);
+  result.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    result.push_back(ComponentString(index, i));
+  }
+  return result;
+}
+
+void PathColumns::Append(const PathStyle& style,
+                         const std::vector<std::string>& paths,
+                         size_t begin,
+                         size_t end) {
+  for (size_t i = begin; i < end; i++) {
+    const std::string& path = paths[i];
+    PathComponentIterator it(style, path.data(), path.length());
+    size_t root_length = it.root_length();
+    if (root_length > 0) {
+      bytes_.append(path.data(), root_length);
+      component_offsets_.push_back(bytes_.length());
+    }
+    while (it.Next()) {
+      bytes_.append(it.component(), it.component_length());
+      component_offsets_.push_back(bytes_.length());
+    }
+    path_components_.push_back(component_offsets_.size() - 1);
+    root_lengths_.push_back(static_cast<uint32_t>(root_length));
+  }
+}
+
+void PathColumns::CopyChunk(const PathColumns& chunk,
+                            uint64_t byte_offset,
+                            uint64_t component_index,
+                            size_t path_index) {
+  if (!chunk.bytes_.empty()) {
+    memcpy(&bytes_[byte_offset], chunk.bytes_.data(), chunk.bytes_.length());
+  }
+  for (size_t i = 1; i < chunk.component_offsets_.size(); i++) {
+    component_offsets_[component_index + i] =
+        byte_offset + chunk.component_offsets_[i];
+  }
+  for (size_t i = 0; i < chunk.root_lengths_.size(); i++) {
+    path_components_[path_index + i + 1] =
+        component_index + chunk.path_components_[i + 1];
+    root_lengths_[path_index + i] = chunk.root_lengths_[i];
+  }
+}
+
+void PathColumns::Build(const Path& path,
+                        const std::vector<std::string>& paths,
+                        int num_threads) {
+  Clear();
+  size_t num_chunks =
+      PathParallel::NumChunks(paths.size(), kMinPathsPerChunk, num_threads);
+  if (num_chunks == 1) {
+    Append(path.style(), paths, 0, paths.size());
+    return;
+  }
+
+  // Split each chunk into its own set of columns.
+  std::vector<std::unique_ptr<PathColumns> > chunks(num_chunks);
+  for (size_t i = 0; i < num_chunks; i++) chunks[i].reset(new PathColumns());
+  PathParallel::ForEachChunk(paths.size(), num_chunks,
+                             [&](size_t chunk, size_t start, size_t end) {
+    chunks[chunk]->Append(path.style(), paths, start, end);
+  });
+
+  // Size the columns for the combined result, then stitch the chunks into
+  // place in parallel, rebasing their offsets.
+  std::vector<uint64_t> byte_offsets(num_chunks + 1, 0);
+  std::vector<uint64_t> component_indices(num_chunks + 1, 0);
+  for (size_t i = 0; i < num_chunks; i++) {
+    byte_offsets[i + 1] = byte_offsets[i] + chunks[i]->bytes_.length();
+    component_indices[i + 1] =
+        component_indices[i] + chunks[i]->num_components();
+  }
+  bytes_.resize(byte_offsets[num_chunks]);
+  component_offsets_.resize(component_indices[num_chunks] + 1);
+  path_components_.resize(paths.size() + 1);
+  root_lengths_.resize(paths.size());
+  PathParallel::ForEachChunk(paths.size(), num_chunks,
+                             [&](size_t chunk, size_t start, size_t end) {
+    CopyChunk(*chunks[chunk], byte_offsets[chunk], component_indices[chunk],
+              start);
+  });
+}
+
+}  // namespace snapshotter
+}  // namespace dart
@@ -0,0 +1,95 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_PATH_COLUMNS_H_
+#define SRC_NATIVE_SNAPSHOTTER_PATH_COLUMNS_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "native/platform/globals.h"
+#include "native/snapshotter/path.h"
+
+namespace dart {
+namespace snapshotter {
+
+// A columnar (structure-of-arrays) representation of the result of calling
+// Path::Split on a large number of paths.
+//
+// All components are stored back to back in a single byte buffer. Component
+// |c| occupies bytes [component_offsets()[c], component_offsets()[c + 1]),
+// and path |p| owns components [path_components()[p],
+// path_components()[p + 1]). As with Path::Split, the first component of a
+// path is its root when root_lengths()[p] is non-zero.
+class PathColumns {
+ public:
+  PathColumns();
+
+  // Splits |paths| according to the style of |path|, replacing the current
+  // contents. The work is done in parallel chunks on up to |num_threads|
+  // threads; zero picks a thread count based on the hardware.
+  void Build(const Path& path,
+             const std::vector<std::string>& paths,
+             int num_threads = 0);
+
+  size_t num_paths() const { return root_lengths_.size(); }
+  size_t num_components() const { return component_offsets_.size() - 1; }
+
+  // The number of components of path |index|, including its root.
+  size_t NumComponents(size_t index) const {
+    return path_components_[index + 1] - path_components_[index];
+  }
+
+  // Returns the |i|th component of path |index| without copying it.
+  const char* Component(size_t index, size_t i, size_t* length) const {
+    size_t c = path_components_[index] + i;
+    *length = component_offsets_[c + 1] - component_offsets_[c];
+    return bytes_.data() + component_offsets_[c];
+  }
+
+  // Returns the |i|th component of path |index| as a string.
+  std::string ComponentString(size_t index, size_t i) const;
+
+  // Returns the components of path |index| exactly as Path::Split would.
+  std::vector<std::string> Split(size_t index) const;
+
+  const std::string& bytes() const { return bytes_; }
+  const std::vector<uint64_t>& component_offsets() const {
+    return component_offsets_;
+  }
+  const std::vector<uint64_t>& path_components() const {
+    return path_components_;
+  }
+  const std::vector<uint32_t>& root_lengths() const { return root_lengths_; }
+
+ private:
+  // Appends the components of |paths|[begin, end) to this.
+  void Append(const PathStyle& style,
+              const std::vector<std::string>& paths,
+              size_t begin,
+              size_t end);
+
+  // Copies the contents of |chunk| into this, starting at the given
+  // positions in each column.
+  void CopyChunk(const PathColumns& chunk,
+                 uint64_t byte_offset,
+                 uint64_t component_index,
+                 size_t path_index);
+
+  void Clear();
+
+  std::string bytes_;
+  std::vector<uint64_t> component_offsets_;
+  std::vector<uint64_t> path_components_;
+  std::vector<uint32_t> root_lengths_;
+
+  DISALLOW_COPY_AND_ASSIGN(PathColumns);
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_PATH_COLUMNS_H_
@@ -0,0 +1,83 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include <sstream>
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path.h"
+#include "native/snapshotter/path_columns.h"
+
+namespace dart {
+namespace snapshotter {
+
+static void ExpectMatchesSplit(const Path& path,
+                               const std::vector<std::string>& paths,
+                               int num_threads) {
+  PathColumns columns;
+  columns.Build(path, paths, num_threads);
+
+  EXPECT_EQ(columns.num_paths(), paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    EXPECT_EQ(columns.Split(i), path.Split(paths[i]));
+    EXPECT_EQ(columns.root_lengths()[i], path.RootPrefix(paths[i]).length());
+  }
+}
+
+void PathColumnsSplitTests() {
+  std::vector<std::string> paths;
+  paths.push_back("");
+  paths.push_back("a");
+  paths.push_back("a/b/c");
+  paths.push_back("/a//b/");
+  paths.push_back("///");
+  paths.push_back("./..//a");
+  paths.push_back("a\\b/c");
+  paths.push_back("C:\\a\\b");
+  paths.push_back("\\\\server\\share\\a");
+  paths.push_back("http://dartlang.org/a/b");
+  paths.push_back("file:///a/b/");
+
+  ExpectMatchesSplit(Path::kPosix, paths, 1);
+  ExpectMatchesSplit(Path::kWindows, paths, 1);
+  ExpectMatchesSplit(Path::kUrl, paths, 1);
+
+  PathColumns columns;
+  columns.Build(Path::kPosix, paths, 1);
+  size_t length;
+  const char* component = columns.Component(3, 1, &length);
+  EXPECT_EQ(std::string(component, length), "a");
+  EXPECT_EQ(columns.NumComponents(0), 0u);
+  EXPECT_EQ(columns.ComponentString(2, 2), "c");
+}
+
+void PathColumnsParallelTests() {
+  std::vector<std::string> paths;
+  for (int i = 0; i < 50000; i++) {
+    std::stringstream path;
+    if (i % 3 == 0) path << "/";
+    path << "dir" << (i % 17) << "/sub" << (i % 5) << "//file" << i << ".dart";
+    paths.push_back(path.str());
+  }
+
+  ExpectMatchesSplit(Path::kPosix, paths, 4);
+  ExpectMatchesSplit(Path::kWindows, paths, 3);
+
+  PathColumns serial;
+  PathColumns parallel;
+  serial.Build(Path::kUrl, paths, 1);
+  parallel.Build(Path::kUrl, paths, 8);
+  EXPECT_EQ(serial.bytes(), parallel.bytes());
+  EXPECT_EQ(serial.component_offsets(), parallel.component_offsets());
+  EXPECT_EQ(serial.path_components(), parallel.path_components());
+  EXPECT_EQ(serial.root_lengths(), parallel.root_lengths());
+}
+
+extern void ExecutePathColumnsTests() {
+  PathColumnsSplitTests();
+  PathColumnsParallelTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
@@ -0,0 +1,212 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/path_ffi.h"
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path.h"
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+#define PATH_FFI_EXCEPTIONS 1
+#endif
+
+namespace dart {
+namespace snapshotter {
+
+// Returns NULL for a value that is not a Snapshotter_PathStyle, which C
+// callers can pass.
+static const Path* PathForStyle(Snapshotter_PathStyle style) {
+  switch (static_cast<int>(style)) {
+    case Snapshotter_kPosixPath:
+      return &Path::kPosix;
+    case Snapshotter_kWindowsPath:
+      return &Path::kWindows;
+    case Snapshotter_kUrlPath:
+      return &Path::kUrl;
+  }
+  return NULL;
+}
+
+// Returns |body()|, or |error| if it throws, so that no exception unwinds
+// into a C caller. Without exceptions, allocation failures abort instead.
+template <typename Result, typename Body>
+static Result Guard(Result error, Body body) {
+#if defined(PATH_FFI_EXCEPTIONS)
+  try {
+    return body();
+  } catch (...) {
+    return error;
+  }
+#else
+  return body();
+#endif
+}
+
+// Copies as much of |result| as fits into |buffer| and returns its length.
+static size_t CopyResult(const std::string& result,
+                         char* buffer,
+                         size_t capacity) {
+  size_t length = result.length();
+  size_t copied = length < capacity ? length : capacity;
+  if (copied > 0) memcpy(buffer, result.data(), copied);
+  return length;
+}
+
+typedef std::string (Path::*PathOperation)(const std::string&) const;
+
+static size_t Apply(Snapshotter_PathStyle style,
+                    PathOperation operation,
+                    const char* data,
+                    size_t length,
+                    char* buffer,
+                    size_t capacity) {
+  const Path* path = PathForStyle(style);
+  if (path == NULL) return SNAPSHOTTER_PATH_ERROR;
+  return Guard(SNAPSHOTTER_PATH_ERROR, [&]() {
+    return CopyResult((path->*operation)(std::string(data, length)), buffer,
+                      capacity);
+  });
+}
+
+static size_t ApplyAll(Snapshotter_PathStyle style,
+                       PathOperation operation,
+                       const Snapshotter_PathSlice* paths,
+                       size_t count,
+                       char* buffer,
+                       size_t capacity,
+                       Snapshotter_PathSlice* results) {
+  const Path* path = PathForStyle(style);
+  if (path == NULL) return SNAPSHOTTER_PATH_ERROR;
+  return Guard(SNAPSHOTTER_PATH_ERROR, [&]() {
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+      std::string result =
+          (path->*operation)(std::string(paths[i].data, paths[i].length));
+      if (total + result.length() <= capacity) {
+        if (!result.empty()) {
+          memcpy(buffer + total, result.data(), result.length());
+        }
+        results[i].data = buffer + total;
+        results[i].length = result.length();
+      }
+      total += result.length();
+    }
+    return total;
+  });
+}
+
+}  // namespace snapshotter
+}  // namespace dart
+
+using dart::snapshotter::Apply;
+using dart::snapshotter::ApplyAll;
+using dart::snapshotter::CopyResult;
+using dart::snapshotter::Guard;
+using dart::snapshotter::Path;
+using dart::snapshotter::PathComponentIterator;
+using dart::snapshotter::PathForStyle;
+
+int Snapshotter_PathIsAbsolute(Snapshotter_PathStyle style,
+                               const char* path,
+                               size_t length) {
+  const Path* p = PathForStyle(style);
+  if (p == NULL) return -1;
+  return p->style().RootLength(path, length) != 0;
+}
+
+size_t Snapshotter_PathNormalize(Snapshotter_PathStyle style,
+                                 const char* path,
+                                 size_t length,
+                                 char* buffer,
+                                 size_t capacity) {
+  return Apply(style, &Path::Normalize, path, length, buffer, capacity);
+}
+
+size_t Snapshotter_PathDirname(Snapshotter_PathStyle style,
+                               const char* path,
+                               size_t length,
+                               char* buffer,
+                               size_t capacity) {
+  return Apply(style, &Path::Dirname, path, length, buffer, capacity);
+}
+
+size_t Snapshotter_PathJoin(Snapshotter_PathStyle style,
+                            const Snapshotter_PathSlice* parts,
+                            size_t count,
+                            char* buffer,
+                            size_t capacity) {
+  const Path* path = PathForStyle(style);
+  if (path == NULL) return SNAPSHOTTER_PATH_ERROR;
+  return Guard(SNAPSHOTTER_PATH_ERROR, [&]() {
+    std::vector<std::string> strings(count);
+    for (size_t i = 0; i < count; i++) {
+      strings[i].assign(parts[i].data, parts[i].length);
+    }
+    return CopyResult(path->JoinAll(strings), buffer, capacity);
+  });
+}
+
+size_t Snapshotter_PathSplit(Snapshotter_PathStyle style,
+                             const char* path,
+                             size_t length,
+                             Snapshotter_PathSlice* components,
+                             size_t capacity) {
+  const Path* p = PathForStyle(style);
+  if (p == NULL) return SNAPSHOTTER_PATH_ERROR;
+  PathComponentIterator it(p->style(), path, length);
+  size_t count = 0;
+  if (it.root_length() > 0) {
+    if (count < capacity) {
+      components[count].data = path;
+      components[count].length = it.root_length();
+    }
+    count++;
+  }
+  while (it.Next()) {
+    if (count < capacity) {
+      components[count].data = it.component();
+      components[count].length = it.component_length();
+    }
+    count++;
+  }
+  return count;
+}
+
+int Snapshotter_PathIsAbsoluteAll(Snapshotter_PathStyle style,
+                                  const Snapshotter_PathSlice* paths,
+                                  size_t count,
+                                  uint8_t* results) {
+  const Path* path = PathForStyle(style);
+  if (path == NULL) return -1;
+  for (size_t i = 0; i < count; i++) {
+    results[i] = path->style().RootLength(paths[i].data, paths[i].length) != 0;
+  }
+  return 0;
+}
+
+size_t Snapshotter_PathNormalizeAll(Snapshotter_PathStyle style,
+                                    const Snapshotter_PathSlice* paths,
+                                    size_t count,
+                                    char* buffer,
+                                    size_t capacity,
+                                    Snapshotter_PathSlice* results) {
+  return ApplyAll(style, &Path::Normalize, paths, count, buffer, capacity,
+                  results);
+}
+
+size_t Snapshotter_PathDirnameAll(Snapshotter_PathStyle style,
+                                  const Snapshotter_PathSlice* paths,
+                                  size_t count,
+                                  char* buffer,
+                                  size_t capacity,
+                                  Snapshotter_PathSlice* results) {
+  return ApplyAll(style, &Path::Dirname, paths, count, buffer, capacity,
+                  results);
+}
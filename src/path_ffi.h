@@ -0,0 +1,95 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_PATH_FFI_H_
+#define SRC_NATIVE_SNAPSHOTTER_PATH_FFI_H_
+
+// A C interface to the Path operations, for callers that bind to them
+// through FFI. Strings are passed as (pointer, length) pairs and need not be
+// NUL-terminated. Results are written to buffers owned by the caller, so
+// nothing returned across this interface has to be freed.
+//
+// Functions that produce a string return its full length and write as much
+// of it as fits in |capacity| bytes. A result is complete only if its
+// length is at most |capacity|; otherwise the caller can retry with a
+// buffer of the returned size. No terminating NUL is written.
+//
+// An unknown style, or running out of memory, is reported by returning
+// SNAPSHOTTER_PATH_ERROR from functions that return a length or a count,
+// and -1 from the others. No C++ exception crosses this interface.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define SNAPSHOTTER_EXPORT __declspec(dllexport)
+#else
+#define SNAPSHOTTER_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SNAPSHOTTER_PATH_ERROR ((size_t)-1)
+
+typedef enum {
+  Snapshotter_kPosixPath = 0,
+  Snapshotter_kWindowsPath = 1,
+  Snapshotter_kUrlPath = 2,
+} Snapshotter_PathStyle;
+
+typedef struct {
+  const char* data;
+  size_t length;
+} Snapshotter_PathSlice;
+
+// Returns 1 if |path| is absolute and 0 if it is not.
+SNAPSHOTTER_EXPORT int Snapshotter_PathIsAbsolute(
+    Snapshotter_PathStyle style, const char* path, size_t length);
+
+SNAPSHOTTER_EXPORT size_t Snapshotter_PathNormalize(
+    Snapshotter_PathStyle style, const char* path, size_t length,
+    char* buffer, size_t capacity);
+
+SNAPSHOTTER_EXPORT size_t Snapshotter_PathDirname(
+    Snapshotter_PathStyle style, const char* path, size_t length,
+    char* buffer, size_t capacity);
+
+// Joins |count| |parts| like Path::JoinAll.
+SNAPSHOTTER_EXPORT size_t Snapshotter_PathJoin(
+    Snapshotter_PathStyle style, const Snapshotter_PathSlice* parts,
+    size_t count, char* buffer, size_t capacity);
+
+// Splits |path| like Path::Split, storing up to |capacity| components in
+// |components| and returning the number of components. The components point
+// into |path|, which must outlive them.
+SNAPSHOTTER_EXPORT size_t Snapshotter_PathSplit(
+    Snapshotter_PathStyle style, const char* path, size_t length,
+    Snapshotter_PathSlice* components, size_t capacity);
+
+// Batch variants, which handle |count| |paths| in one call. IsAbsoluteAll
+// stores 1 or 0 for each path in |results|, and returns 0. NormalizeAll
+// and DirnameAll pack their results one after another into |buffer| and
+// point |results| at them. They return the total length, and |results| is
+// only complete if it is at most |capacity|.
+SNAPSHOTTER_EXPORT int Snapshotter_PathIsAbsoluteAll(
+    Snapshotter_PathStyle style, const Snapshotter_PathSlice* paths,
+    size_t count, uint8_t* results);
+
+SNAPSHOTTER_EXPORT size_t Snapshotter_PathNormalizeAll(
+    Snapshotter_PathStyle style, const Snapshotter_PathSlice* paths,
+    size_t count, char* buffer, size_t capacity,
+    Snapshotter_PathSlice* results);
+
+SNAPSHOTTER_EXPORT size_t Snapshotter_PathDirnameAll(
+    Snapshotter_PathStyle style, const Snapshotter_PathSlice* paths,
+    size_t count, char* buffer, size_t capacity,
+    Snapshotter_PathSlice* results);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_PATH_FFI_H_
@@ -0,0 +1,166 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path.h"
+#include "native/snapshotter/path_ffi.h"
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+namespace dart {
+namespace snapshotter {
+
+static Snapshotter_PathSlice Slice(const char* string) {
+  Snapshotter_PathSlice slice = { string, strlen(string) };
+  return slice;
+}
+
+static std::string String(const Snapshotter_PathSlice& slice) {
+  return std::string(slice.data, slice.length);
+}
+
+void PathFfiStringTests() {
+  char buffer[64];
+  const char* path = "a/b/../c//";
+  size_t length = Snapshotter_PathNormalize(
+      Snapshotter_kPosixPath, path, strlen(path), buffer, sizeof(buffer));
+  EXPECT_EQ(std::string(buffer, length), "a/c");
+
+  // reports the full length when the buffer is too small
+  EXPECT_EQ(Snapshotter_PathNormalize(
+      Snapshotter_kPosixPath, path, strlen(path), NULL, 0), 3u);
+  memset(buffer, 0, sizeof(buffer));
+  EXPECT_EQ(Snapshotter_PathNormalize(
+      Snapshotter_kPosixPath, path, strlen(path), buffer, 2), 3u);
+  EXPECT_EQ(std::string(buffer), "a/");
+
+  path = "C:/a/b\\c";
+  length = Snapshotter_PathDirname(
+      Snapshotter_kWindowsPath, path, strlen(path), buffer, sizeof(buffer));
+  EXPECT_EQ(std::string(buffer, length),
+      Path::kWindows.Dirname("C:/a/b\\c"));
+  length = Snapshotter_PathNormalize(
+      Snapshotter_kWindowsPath, path, strlen(path), buffer, sizeof(buffer));
+  EXPECT_EQ(std::string(buffer, length), "C:\\a\\b\\c");
+
+  Snapshotter_PathSlice parts[] = {
+    Slice("http://dartlang.org"), Slice("a"), Slice("/b"), Slice("c")
+  };
+  length = Snapshotter_PathJoin(Snapshotter_kUrlPath, parts,
+                                ARRAY_SIZE(parts), buffer, sizeof(buffer));
+  EXPECT_EQ(std::string(buffer, length), "http://dartlang.org/b/c");
+
+  EXPECT(Snapshotter_PathIsAbsolute(Snapshotter_kPosixPath, "/a", 2));
+  EXPECT(!Snapshotter_PathIsAbsolute(Snapshotter_kPosixPath, "a", 1));
+  EXPECT(Snapshotter_PathIsAbsolute(Snapshotter_kWindowsPath, "C:\\", 3));
+  EXPECT(!Snapshotter_PathIsAbsolute(Snapshotter_kPosixPath, "C:\\", 3));
+}
+
+void PathFfiSplitTests() {
+  Snapshotter_PathSlice components[4];
+  const char* path = "/a//b/./c/";
+  size_t count = Snapshotter_PathSplit(
+      Snapshotter_kPosixPath, path, strlen(path), components, 4);
+  EXPECT_EQ(count, 5u);
+  EXPECT_EQ(String(components[0]), "/");
+  EXPECT_EQ(String(components[1]), "a");
+  EXPECT_EQ(String(components[2]), "b");
+  EXPECT_EQ(String(components[3]), ".");
+  // points into the input and counts components that don't fit
+  EXPECT_EQ(components[1].data, path + 1);
+
+  path = "\\\\server\\share\\a\\b\\c\\d";
+  count = Snapshotter_PathSplit(
+      Snapshotter_kWindowsPath, path, strlen(path), components, 2);
+  EXPECT_EQ(count, 5u);
+  EXPECT_EQ(String(components[0]), "\\\\server\\share");
+  EXPECT_EQ(String(components[1]), "a");
+
+  const char* paths[] = {
+    "", "a", "a/b/../c", "file:///a/b/", "http://x.org", "\\\\s\\t\\u"
+  };
+  for (size_t i = 0; i < ARRAY_SIZE(paths); i++) {
+    std::vector<std::string> expected = Path::kUrl.Split(paths[i]);
+    count = Snapshotter_PathSplit(
+        Snapshotter_kUrlPath, paths[i], strlen(paths[i]), components, 4);
+    EXPECT_EQ(count, expected.size());
+    for (size_t j = 0; j < count && j < 4; j++) {
+      EXPECT_EQ(String(components[j]), expected[j]);
+    }
+  }
+}
+
+void PathFfiBatchTests() {
+  Snapshotter_PathSlice paths[] = {
+    Slice("a/./b"), Slice("/"), Slice(""), Slice("x/../../y")
+  };
+  Snapshotter_PathSlice results[ARRAY_SIZE(paths)];
+  char buffer[64];
+  size_t total = Snapshotter_PathNormalizeAll(
+      Snapshotter_kPosixPath, paths, ARRAY_SIZE(paths), buffer,
+      sizeof(buffer), results);
+  EXPECT_EQ(total, 9u);
+  EXPECT_EQ(String(results[0]), "a/b");
+  EXPECT_EQ(String(results[1]), "/");
+  EXPECT_EQ(String(results[2]), ".");
+  EXPECT_EQ(String(results[3]), "../y");
+  EXPECT_EQ(results[1].data, results[0].data + 3);
+
+  EXPECT_EQ(Snapshotter_PathNormalizeAll(
+      Snapshotter_kPosixPath, paths, ARRAY_SIZE(paths), NULL, 0, results),
+      9u);
+
+  total = Snapshotter_PathDirnameAll(
+      Snapshotter_kPosixPath, paths, ARRAY_SIZE(paths), buffer,
+      sizeof(buffer), results);
+  for (size_t i = 0; i < ARRAY_SIZE(paths); i++) {
+    EXPECT_EQ(String(results[i]), Path::kPosix.Dirname(String(paths[i])));
+  }
+
+  uint8_t absolute[ARRAY_SIZE(paths)];
+  EXPECT_EQ(Snapshotter_PathIsAbsoluteAll(
+      Snapshotter_kPosixPath, paths, ARRAY_SIZE(paths), absolute), 0);
+  EXPECT_EQ(absolute[0], 0);
+  EXPECT_EQ(absolute[1], 1);
+  EXPECT_EQ(absolute[2], 0);
+  EXPECT_EQ(absolute[3], 0);
+}
+
+void PathFfiInvalidStyleTests() {
+  Snapshotter_PathStyle style = static_cast<Snapshotter_PathStyle>(7);
+  Snapshotter_PathSlice paths[] = { Slice("a/b") };
+  Snapshotter_PathSlice results[ARRAY_SIZE(paths)];
+  char buffer[16];
+  uint8_t absolute[ARRAY_SIZE(paths)];
+  EXPECT_EQ(Snapshotter_PathIsAbsolute(style, "/a", 2), -1);
+  EXPECT_EQ(Snapshotter_PathNormalize(style, "a", 1, buffer, sizeof(buffer)),
+            SNAPSHOTTER_PATH_ERROR);
+  EXPECT_EQ(Snapshotter_PathDirname(style, "a", 1, buffer, sizeof(buffer)),
+            SNAPSHOTTER_PATH_ERROR);
+  EXPECT_EQ(Snapshotter_PathJoin(style, paths, 1, buffer, sizeof(buffer)),
+            SNAPSHOTTER_PATH_ERROR);
+  EXPECT_EQ(Snapshotter_PathSplit(style, "a/b", 3, results, 1),
+            SNAPSHOTTER_PATH_ERROR);
+  EXPECT_EQ(Snapshotter_PathIsAbsoluteAll(style, paths, 1, absolute), -1);
+  EXPECT_EQ(Snapshotter_PathNormalizeAll(
+      style, paths, 1, buffer, sizeof(buffer), results),
+      SNAPSHOTTER_PATH_ERROR);
+  EXPECT_EQ(Snapshotter_PathDirnameAll(
+      style, paths, 1, buffer, sizeof(buffer), results),
+      SNAPSHOTTER_PATH_ERROR);
+}
+
+extern void ExecutePathFfiTests() {
+  PathFfiStringTests();
+  PathFfiSplitTests();
+  PathFfiBatchTests();
+  PathFfiInvalidStyleTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
@@ -0,0 +1,105 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/path_groups.h"
+
+#include "native/platform/assert.h"
+#include "native/snapshotter/path_hash.h"
+
+#include <stdint.h>
+#include <string.h>
+
+namespace dart {
+namespace snapshotter {
+
+static const size_t kInitialSlots = 16;
+
+// Splits the normalized |path| into its Dirname, which is either a prefix
+// of it or ".", and the offset of its last component.
+static void SplitParent(const PathStyle& style,
+                        const std::string& path,
+                        const char** parent,
+                        size_t* parent_length,
+                        size_t* name_start) {
+  size_t root_length = style.RootLength(path);
+  size_t start = path.length();
+  while (start > root_length && !style.IsSeparator(path[start - 1])) start--;
+  *name_start = start;
+  // A normalized path has a single separator before each component.
+  size_t end = start;
+  if (end > root_length) end--;
+  if (end > 0) {
+    *parent = path.data();
+    *parent_length = end;
+  } else {
+    *parent = ".";
+    *parent_length = 1;
+  }
+}
+
+void PathGroups::GroupByParent(const Path& path,
+                               const std::vector<std::string>& paths,
+                               std::vector<ParentGroup>* groups) {
+  groups->clear();
+  // Open addressing over |groups|, kept at most half full. Each slot holds
+  // one more than the index of its group, or zero.
+  std::vector<size_t> slots(kInitialSlots, 0);
+  std::vector<uint32_t> hashes;
+  std::string normalized;
+
+  for (size_t i = 0; i < paths.size(); i++) {
+    const std::string* current = &paths[i];
+    if (!path.IsNormalized(*current)) {
+      normalized = path.Normalize(*current);
+      current = &normalized;
+    }
+    const char* parent;
+    size_t parent_length;
+    size_t name_start;
+    SplitParent(path.style(), *current, &parent, &parent_length,
+                &name_start);
+
+    uint32_t hash = PathHash::Fnv1a32(parent, parent_length);
+    size_t mask = slots.size() - 1;
+    size_t slot = hash & mask;
+    while (slots[slot] != 0) {
+      const ParentGroup& group = (*groups)[slots[slot] - 1];
+      if (hashes[slots[slot] - 1] == hash &&
+          group.parent.length() == parent_length &&
+          memcmp(group.parent.data(), parent, parent_length) == 0) {
+        break;
+      }
+      slot = (slot + 1) & mask;
+    }
+    size_t index;
+    if (slots[slot] != 0) {
+      index = slots[slot] - 1;
+    } else {
+      index = groups->size();
+      groups->push_back(ParentGroup());
+      groups->back().parent.assign(parent, parent_length);
+      hashes.push_back(hash);
+      slots[slot] = index + 1;
+      if (2 * groups->size() > slots.size()) {
+        // Grow the table and place every group again.
+        slots.assign(2 * slots.size(), 0);
+        mask = slots.size() - 1;
+        for (size_t j = 0; j < hashes.size(); j++) {
+          size_t k = hashes[j] & mask;
+          while (slots[k] != 0) k = (k + 1) & mask;
+          slots[k] = j + 1;
+        }
+      }
+    }
+
+    ParentGroup& group = (*groups)[index];
+    ParentGroup::Member member;
+    member.index = i;
+    member.name.assign(*current, name_start, std::string::npos);
+    group.members.push_back(member);
+  }
+}
+
+}  // namespace snapshotter
+}  // namespace dart
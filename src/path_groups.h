@@ -0,0 +1,49 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_PATH_GROUPS_H_
+#define SRC_NATIVE_SNAPSHOTTER_PATH_GROUPS_H_
+
+#include <string>
+#include <vector>
+
+#include "native/platform/globals.h"
+#include "native/snapshotter/path.h"
+
+namespace dart {
+namespace snapshotter {
+
+// The paths that share a parent directory.
+struct ParentGroup {
+  struct Member {
+    // The index of the path in the input.
+    size_t index;
+    // The last component of the normalized path, or "" for a root.
+    std::string name;
+  };
+
+  // Path::Dirname of the normalized paths.
+  std::string parent;
+  std::vector<Member> members;
+};
+
+class PathGroups {
+ public:
+  // Groups |paths| by the parent directory of their normalized form, so
+  // that each directory can be opened once and its files reached by name.
+  // Groups are stored in the order their parents first appear, and members
+  // in input order. Paths that are already normalized are grouped without
+  // building their parent string, except once for each new group.
+  static void GroupByParent(const Path& path,
+                            const std::vector<std::string>& paths,
+                            std::vector<ParentGroup>* groups);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(PathGroups);
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_PATH_GROUPS_H_
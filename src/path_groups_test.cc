@@ -0,0 +1,106 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path.h"
+#include "native/snapshotter/path_groups.h"
+
+#include <stdio.h>
+
+namespace dart {
+namespace snapshotter {
+
+void PathGroupsPosixTests() {
+  const Path& path = Path::kPosix;
+  std::vector<std::string> paths;
+  paths.push_back("/a/b/c.dart");
+  paths.push_back("/a/x");
+  paths.push_back("/a/b/d.dart");
+  paths.push_back("/a//b/./e.dart");
+  paths.push_back("/a/b/f/../g.dart");
+  paths.push_back("/");
+  paths.push_back("/top");
+  paths.push_back("rel");
+  paths.push_back("rel/..");
+  paths.push_back("../up");
+  std::vector<ParentGroup> groups;
+  PathGroups::GroupByParent(path, paths, &groups);
+
+  EXPECT_EQ(groups.size(), 5u);
+  EXPECT_EQ(groups[0].parent, "/a/b");
+  EXPECT_EQ(groups[0].members.size(), 4u);
+  EXPECT_EQ(groups[0].members[0].index, 0u);
+  EXPECT_EQ(groups[0].members[0].name, "c.dart");
+  EXPECT_EQ(groups[0].members[1].name, "d.dart");
+  EXPECT_EQ(groups[0].members[2].index, 3u);
+  EXPECT_EQ(groups[0].members[2].name, "e.dart");
+  EXPECT_EQ(groups[0].members[3].name, "g.dart");
+  EXPECT_EQ(groups[1].parent, "/a");
+  EXPECT_EQ(groups[1].members.size(), 1u);
+  EXPECT_EQ(groups[1].members[0].name, "x");
+  EXPECT_EQ(groups[2].parent, "/");
+  EXPECT_EQ(groups[2].members.size(), 2u);
+  EXPECT_EQ(groups[2].members[0].name, "");
+  EXPECT_EQ(groups[2].members[1].name, "top");
+  EXPECT_EQ(groups[3].parent, ".");
+  EXPECT_EQ(groups[3].members.size(), 2u);
+  EXPECT_EQ(groups[3].members[0].name, "rel");
+  EXPECT_EQ(groups[3].members[1].name, ".");
+  EXPECT_EQ(groups[4].parent, "..");
+  EXPECT_EQ(groups[4].members[0].name, "up");
+
+  // agrees with Dirname for many groups
+  paths.clear();
+  for (int i = 0; i < 5000; i++) {
+    char name[64];
+    snprintf(name, sizeof(name), "/pkg%d/lib/./file%d.dart", i % 997, i);
+    paths.push_back(name);
+  }
+  PathGroups::GroupByParent(path, paths, &groups);
+  EXPECT_EQ(groups.size(), 997u);
+  size_t members = 0;
+  for (size_t i = 0; i < groups.size(); i++) {
+    for (size_t j = 0; j < groups[i].members.size(); j++) {
+      const ParentGroup::Member& member = groups[i].members[j];
+      std::string normalized = path.Normalize(paths[member.index]);
+      EXPECT_EQ(groups[i].parent, path.Dirname(normalized));
+      EXPECT_EQ(path.Join(groups[i].parent, member.name), normalized);
+      members++;
+    }
+  }
+  EXPECT_EQ(members, paths.size());
+}
+
+void PathGroupsOtherStyleTests() {
+  std::vector<std::string> paths;
+  paths.push_back("C:\\a\\b");
+  paths.push_back("C:/a/c");
+  paths.push_back("C:\\d");
+  std::vector<ParentGroup> groups;
+  PathGroups::GroupByParent(Path::kWindows, paths, &groups);
+  EXPECT_EQ(groups.size(), 2u);
+  EXPECT_EQ(groups[0].parent, "C:\\a");
+  EXPECT_EQ(groups[0].members.size(), 2u);
+  EXPECT_EQ(groups[1].parent, "C:\\");
+
+  paths.clear();
+  paths.push_back("http://dartlang.org/a");
+  paths.push_back("http://dartlang.org/b/c");
+  paths.push_back("http://dartlang.org/d");
+  PathGroups::GroupByParent(Path::kUrl, paths, &groups);
+  EXPECT_EQ(groups.size(), 2u);
+  EXPECT_EQ(groups[0].parent, "http://dartlang.org");
+  EXPECT_EQ(groups[0].members.size(), 2u);
+  EXPECT_EQ(groups[0].members[1].name, "d");
+  EXPECT_EQ(groups[1].parent, "http://dartlang.org/b");
+}
+
+extern void ExecutePathGroupsTests() {
+  PathGroupsPosixTests();
+  PathGroupsOtherStyleTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
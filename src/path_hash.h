@@ -0,0 +1,51 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_PATH_HASH_H_
+#define SRC_NATIVE_SNAPSHOTTER_PATH_HASH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "native/platform/globals.h"
+
+namespace dart {
+namespace snapshotter {
+
+// The FNV-1a hash used by the hash tables over paths: PathIndex files,
+// PathGroups and ExtensionClassifier. PathIndex stores the hashes, so they
+// must not change. Both widths work in constant expressions.
+class PathHash {
+ public:
+  static const uint32_t kOffsetBasis32 = 2166136261u;
+  static const uint64_t kOffsetBasis64 = 14695981039346656037ULL;
+
+  // Hashes |data|, starting from |seed| instead of the offset basis if it
+  // is given.
+  static constexpr uint32_t Fnv1a32(const char* data,
+                                    size_t length,
+                                    uint32_t seed = kOffsetBasis32) {
+    uint32_t hash = seed;
+    for (size_t i = 0; i < length; i++) {
+      hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+    }
+    return hash;
+  }
+
+  static constexpr uint64_t Fnv1a64(const char* data, size_t length) {
+    uint64_t hash = kOffsetBasis64;
+    for (size_t i = 0; i < length; i++) {
+      hash = (hash ^ static_cast<uint8_t>(data[i])) * 1099511628211ULL;
+    }
+    return hash;
+  }
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(PathHash);
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_PATH_HASH_H_
@@ -0,0 +1,219 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/path_index.h"
+
+#include "native/platform/assert.h"
+#include "native/snapshotter/path_hash.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(TARGET_OS_WINDOWS)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+
+namespace dart {
+namespace snapshotter {
+
+static const char kMagic[4] = { 'P', 'I', 'D', 'X' };
+
+uint64_t PathIndex::Hash(const char* data, size_t length) {
+  return PathHash::Fnv1a64(data, length);
+}
+
+PathIndex::PathIndex()
+    : path_(&Path::kPosix),
+      slots_(NULL),
+      blob_(NULL),
+      num_slots_(0),
+      blob_length_(0),
+      size_(0),
+      mapping_(NULL),
+      mapping_length_(0) {}
+
+PathIndex::~PathIndex() {
+  Close();
+}
+
+void PathIndex::Close() {
+#if defined(TARGET_OS_WINDOWS)
+  free(mapping_);
+#else
+  if (mapping_ != NULL) munmap(mapping_, mapping_length_);
+#endif
+  mapping_ = NULL;
+  mapping_length_ = 0;
+  slots_ = NULL;
+  blob_ = NULL;
+  num_slots_ = 0;
+  blob_length_ = 0;
+  size_ = 0;
+}
+
+bool PathIndex::Open(const char* filename) {
+  Close();
+#if defined(TARGET_OS_WINDOWS)
+  // Without a portable mmap, read the file into memory instead.
+  FILE* file = fopen(filename, "rb");
+  if (file == NULL) return false;
+  fseek(file, 0, SEEK_END);
+  long length = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  void* data = length > 0 ? malloc(length) : NULL;
+  bool ok = data != NULL &&
+      fread(data, 1, length, file) == static_cast<size_t>(length);
+  fclose(file);
+  if (!ok) {
+    free(data);
+    return false;
+  }
+#else
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    return false;
+  }
+  size_t length = st.st_size;
+  void* data = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) return false;
+#endif
+  if (!Init(data, length)) {
+#if defined(TARGET_OS_WINDOWS)
+    free(data);
+#else
+    munmap(data, length);
+#endif
+    return false;
+  }
+  mapping_ = data;
+  mapping_length_ = length;
+  return true;
+}
+
+bool PathIndex::Init(const void* data, size_t length) {
+  Close();
+  if (length < sizeof(Header)) return false;
+  const Header* header = static_cast<const Header*>(data);
+  if (memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 ||
+      header->version != kVersion) {
+    return false;
+  }
+  const Path* path = Path::FromId(header->style);
+  if (path == NULL) return false;
+  uint64_t num_slots = header->num_slots;
+  if (num_slots == 0 || (num_slots & (num_slots - 1)) != 0 ||
+      header->size >= num_slots) {
+    return false;
+  }
+  size_t available = length - sizeof(Header);
+  if (num_slots > available / sizeof(Slot)) return false;
+  available -= num_slots * sizeof(Slot);
+  if (header->blob_length != available) return false;
+
+  const char* bytes = static_cast<const char*>(data);
+  path_ = path;
+  slots_ = reinterpret_cast<const Slot*>(bytes + sizeof(Header));
+  blob_ = bytes + sizeof(Header) + num_slots * sizeof(Slot);
+  num_slots_ = num_slots;
+  blob_length_ = header->blob_length;
+  size_ = header->size;
+  return true;
+}
+
+bool PathIndex::Contains(const std::string& path) const {
+  std::string normalized = path_->Normalize(path);
+  return ContainsNormalized(normalized.data(), normalized.length());
+}
+
+bool PathIndex::ContainsNormalized(const char* path, size_t length) const {
+  if (num_slots_ == 0) return false;
+  uint64_t hash = Hash(path, length);
+  uint64_t mask = num_slots_ - 1;
+  // A valid index is never full, but a corrupt one may be, so stop after
+  // visiting every slot.
+  uint64_t i = hash & mask;
+  for (uint64_t probes = 0; probes < num_slots_; probes++) {
+    const Slot& slot = slots_[i];
+    if (slot.length == kEmptySlot) return false;
+    if (slot.hash == hash && slot.length == length &&
+        static_cast<uint64_t>(slot.offset) + slot.length <= blob_length_ &&
+        memcmp(blob_ + slot.offset, path, length) == 0) {
+      return true;
+    }
+    i = (i + 1) & mask;
+  }
+  return false;
+}
+
+void PathIndexBuilder::Add(const std::string& path) {
+  paths_.push_back(path_.Normalize(path));
+}
+
+bool PathIndexBuilder::Finish(std::string* out) {
+  std::sort(paths_.begin(), paths_.end());
+  paths_.erase(std::unique(paths_.begin(), paths_.end()), paths_.end());
+
+  // Keep the load factor at or below one half.
+  uint64_t num_slots = 1;
+  while (num_slots < paths_.size() * 2 + 1) num_slots <<= 1;
+
+  std::vector<PathIndex::Slot> slots(num_slots);
+  for (size_t i = 0; i < slots.size(); i++) {
+    slots[i].hash = 0;
+    slots[i].offset = 0;
+    slots[i].length = PathIndex::kEmptySlot;
+  }
+  std::string blob;
+  for (size_t i = 0; i < paths_.size(); i++) {
+    const std::string& path = paths_[i];
+    // Offsets and lengths are stored in 32 bits.
+    if (blob.length() + path.length() >= PathIndex::kEmptySlot) return false;
+    uint64_t hash = PathIndex::Hash(path.data(), path.length());
+    uint64_t index = hash & (num_slots - 1);
+    while (slots[index].length != PathIndex::kEmptySlot) {
+      index = (index + 1) & (num_slots - 1);
+    }
+    slots[index].hash = hash;
+    slots[index].offset = static_cast<uint32_t>(blob.length());
+    slots[index].length = static_cast<uint32_t>(path.length());
+    blob.append(path);
+  }
+
+  PathIndex::Header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = PathIndex::kVersion;
+  header.style = path_.id();
+  header.size = paths_.size();
+  header.num_slots = num_slots;
+  header.blob_length = blob.length();
+
+  out->append(reinterpret_cast<const char*>(&header), sizeof(header));
+  out->append(reinterpret_cast<const char*>(&slots[0]),
+              slots.size() * sizeof(PathIndex::Slot));
+  out->append(blob);
+  return true;
+}
+
+bool PathIndexBuilder::WriteToFile(const char* filename) {
+  std::string data;
+  if (!Finish(&data)) return false;
+  FILE* file = fopen(filename, "wb");
+  if (file == NULL) return false;
+  bool ok = fwrite(data.data(), 1, data.length(), file) == data.length();
+  return fclose(file) == 0 && ok;
+}
+
+}  // namespace snapshotter
+}  // namespace dart
@@ -0,0 +1,116 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_PATH_INDEX_H_
+#define SRC_NATIVE_SNAPSHOTTER_PATH_INDEX_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "native/platform/globals.h"
+#include "native/snapshotter/path.h"
+
+namespace dart {
+namespace snapshotter {
+
+// A persistent set of normalized paths that can be memory mapped and
+// queried in place, without deserializing it first.
+//
+// The file is a fixed header, an open-addressing hash table of slots keyed
+// by the 64-bit FNV-1a hash of each normalized path, and a blob holding the
+// path bytes the slots point into. Integers are stored in host byte order,
+// so files are only portable between hosts of the same endianness.
+class PathIndex {
+ public:
+  PathIndex();
+  ~PathIndex();
+
+  // Maps the index stored in |filename|. Returns false if the file cannot be
+  // read or is not a valid index.
+  bool Open(const char* filename);
+
+  // Uses the index serialized in |data|, which must stay alive and
+  // unchanged for as long as this is in use.
+  bool Init(const void* data, size_t length);
+
+  // The style the paths were normalized with when the index was built.
+  const Path& path() const { return *path_; }
+
+  size_t size() const { return size_; }
+
+  // Returns true if the normalized form of |path| is in the index.
+  bool Contains(const std::string& path) const;
+
+  // Returns true if |path|, which must already be normalized, is in the
+  // index. Does not allocate.
+  bool ContainsNormalized(const char* path, size_t length) const;
+
+  static uint64_t Hash(const char* data, size_t length);
+
+ private:
+  friend class PathIndexBuilder;
+
+  struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t style;
+    uint32_t reserved;
+    uint64_t size;
+    uint64_t num_slots;
+    uint64_t blob_length;
+  };
+
+  struct Slot {
+    uint64_t hash;
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  static const uint32_t kVersion = 1;
+  static const uint32_t kEmptySlot = 0xffffffff;
+
+  void Close();
+
+  const Path* path_;
+  const Slot* slots_;
+  const char* blob_;
+  uint64_t num_slots_;
+  uint64_t blob_length_;
+  size_t size_;
+
+  // The mapping owned by this index, if it was opened from a file.
+  void* mapping_;
+  size_t mapping_length_;
+
+  DISALLOW_COPY_AND_ASSIGN(PathIndex);
+};
+
+// Collects paths and writes them out in the PathIndex format.
+class PathIndexBuilder {
+ public:
+  explicit PathIndexBuilder(const Path& path) : path_(path) {}
+
+  // Adds the normalized form of |path|.
+  void Add(const std::string& path);
+
+  // Appends the serialized index to |out|. Returns false, without
+  // appending anything, if the paths add up to 4GB or more.
+  bool Finish(std::string* out);
+
+  // Writes the serialized index to |filename|. Returns false on failure.
+  bool WriteToFile(const char* filename);
+
+ private:
+  const Path& path_;
+  std::vector<std::string> paths_;
+
+  DISALLOW_COPY_AND_ASSIGN(PathIndexBuilder);
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_PATH_INDEX_H_
@@ -0,0 +1,110 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sstream>
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path.h"
+#include "native/snapshotter/path_hash.h"
+#include "native/snapshotter/path_index.h"
+
+namespace dart {
+namespace snapshotter {
+
+// The hashes are stored in index files, so they must stay FNV-1a.
+static_assert(PathHash::Fnv1a32("", 0) == 0x811c9dc5u, "");
+static_assert(PathHash::Fnv1a32("a", 1) == 0xe40c292cu, "");
+static_assert(PathHash::Fnv1a64("a", 1) == 0xaf63dc4c8601ec8cULL, "");
+
+void PathIndexLookupTests() {
+  PathIndexBuilder builder(Path::kPosix);
+  for (int i = 0; i < 1000; i++) {
+    std::stringstream path;
+    path << "/src/./pkg" << (i % 13) << "//lib/file" << i << ".dart";
+    builder.Add(path.str());
+  }
+  builder.Add("a/b/../c");
+  builder.Add("a/c");
+  std::string data;
+  EXPECT(builder.Finish(&data));
+
+  PathIndex index;
+  EXPECT(index.Init(data.data(), data.length()));
+  EXPECT_EQ(&index.path(), &Path::kPosix);
+  EXPECT_EQ(index.size(), 1001u);
+  EXPECT(index.Contains("/src/pkg0/lib/file0.dart"));
+  EXPECT(index.Contains("/src/pkg11/lib/../lib/file999.dart"));
+  EXPECT(index.ContainsNormalized("a/c", 3));
+  EXPECT(!index.ContainsNormalized("a/b/../c", 8));
+  EXPECT(!index.Contains("/src/pkg0/lib/file1.dart"));
+  EXPECT(!index.Contains(""));
+
+  // Truncated and corrupted data is rejected.
+  EXPECT(!index.Init(data.data(), data.length() - 1));
+  EXPECT(!index.Init(data.data(), 8));
+  std::string corrupt = data;
+  corrupt[0] = 'X';
+  EXPECT(!index.Init(corrupt.data(), corrupt.length()));
+  // A failed Init does not keep using the previous data.
+  EXPECT_EQ(index.size(), 0u);
+  EXPECT(!index.Contains("a/c"));
+}
+
+void PathIndexFullTableTests() {
+  PathIndexBuilder builder(Path::kPosix);
+  builder.Add("a");
+  std::string data;
+  EXPECT(builder.Finish(&data));
+
+  // Fill every empty slot with an empty path, so that no probe sequence
+  // ends at an empty slot.
+  const size_t kHeaderSize = 40;
+  const size_t kSlotSize = 16;
+  const size_t kNumSlots = 4;
+  for (size_t i = 0; i < kNumSlots; i++) {
+    char* length = &data[kHeaderSize + i * kSlotSize + 12];
+    if (memcmp(length, "\xff\xff\xff\xff", 4) == 0) memset(length, 0, 4);
+  }
+  PathIndex index;
+  EXPECT(index.Init(data.data(), data.length()));
+  EXPECT(index.Contains("a"));
+  EXPECT(!index.Contains("b"));
+}
+
+void PathIndexFileTests() {
+  PathIndexBuilder builder(Path::kWindows);
+  builder.Add("C:/a/b");
+  builder.Add("C:\\a\\.\\c");
+
+  char filename[] = "/tmp/path_index_test_XXXXXX";
+  int fd = mkstemp(filename);
+  EXPECT(fd >= 0);
+  close(fd);
+  EXPECT(builder.WriteToFile(filename));
+
+  PathIndex index;
+  EXPECT(index.Open(filename));
+  EXPECT_EQ(&index.path(), &Path::kWindows);
+  EXPECT(index.Contains("C:\\a\\b"));
+  EXPECT(index.Contains("C:/a/c"));
+  EXPECT(!index.Contains("C:/a"));
+  unlink(filename);
+
+  EXPECT(!index.Open(filename));
+}
+
+extern void ExecutePathIndexTests() {
+  PathIndexLookupTests();
+  PathIndexFullTableTests();
+  PathIndexFileTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
@@ -0,0 +1,276 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/path_list.h"
+
+#include "native/platform/assert.h"
+
+#include <string.h>
+
+namespace dart {
+namespace snapshotter {
+
+static const char kMagic[] = "PLST";
+static const uint32_t kVersion = 1;
+
+static void WriteVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+// Reads a varint from |data| at |*offset| without bounds checks, advancing
+// |*offset| past it.
+static uint64_t ReadVarint(const char* data, size_t* offset) {
+  uint64_t value = 0;
+  int shift = 0;
+  uint8_t byte;
+  do {
+    byte = static_cast<uint8_t>(data[(*offset)++]);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    shift += 7;
+  } while ((byte & 0x80) != 0);
+  return value;
+}
+
+// Like ReadVarint, but fails instead of reading past |length|.
+static bool ReadCheckedVarint(const char* data,
+                              size_t length,
+                              size_t* offset,
+                              uint64_t* value) {
+  *value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (*offset >= length) return false;
+    uint8_t byte = static_cast<uint8_t>(data[(*offset)++]);
+    *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) return true;
+  }
+  return false;
+}
+
+static void WriteUint64(uint64_t value, std::string* out) {
+  for (int i = 0; i < 8; i++) {
+    out->push_back(static_cast<char>(value >> (i * 8)));
+  }
+}
+
+static bool ReadUint64(const char* data,
+                       size_t length,
+                       size_t* offset,
+                       uint64_t* value) {
+  if (*offset > length || length - *offset < 8) return false;
+  *value = 0;
+  for (int i = 0; i < 8; i++) {
+    *value |= static_cast<uint64_t>(
+        static_cast<uint8_t>(data[*offset + i])) << (i * 8);
+  }
+  *offset += 8;
+  return true;
+}
+
+// Compares |a| with |b| in byte order, like std::string::compare.
+static int Compare(const char* a,
+                   size_t a_length,
+                   const char* b,
+                   size_t b_length) {
+  size_t length = a_length < b_length ? a_length : b_length;
+  int result = length == 0 ? 0 : memcmp(a, b, length);
+  if (result != 0) return result;
+  if (a_length == b_length) return 0;
+  return a_length < b_length ? -1 : 1;
+}
+
+PathList::PathList() : size_(0) {}
+
+void PathList::Build(const std::vector<std::string>& paths) {
+  data_.clear();
+  block_offsets_.clear();
+  size_ = paths.size();
+  for (size_t i = 0; i < paths.size(); i++) {
+    const std::string& path = paths[i];
+    if (i % kBlockSize == 0) {
+      block_offsets_.push_back(data_.length());
+      WriteVarint(path.length(), &data_);
+      data_.append(path);
+      continue;
+    }
+    const std::string& previous = paths[i - 1];
+    ASSERT(previous <= path);
+    size_t shared = 0;
+    size_t limit = previous.length() < path.length() ?
+        previous.length() : path.length();
+    while (shared < limit && previous[shared] == path[shared]) shared++;
+    WriteVarint(shared, &data_);
+    WriteVarint(path.length() - shared, &data_);
+    data_.append(path, shared, std::string::npos);
+  }
+}
+
+const char* PathList::BlockHead(size_t block, size_t* length) const {
+  size_t offset = block_offsets_[block];
+  *length = ReadVarint(data_.data(), &offset);
+  return data_.data() + offset;
+}
+
+std::string PathList::Get(size_t index) const {
+  ASSERT(index < size_);
+  Iterator it(*this, index);
+  return it.current();
+}
+
+size_t PathList::LowerBound(const std::string& path) const {
+  // Find the first block whose head is greater than |path|; the answer then
+  // lies in the block before it.
+  size_t low = 0;
+  size_t high = block_offsets_.size();
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    size_t length;
+    const char* head = BlockHead(middle, &length);
+    if (Compare(head, length, path.data(), path.length()) <= 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  if (low == 0) return 0;
+
+  size_t end = low * kBlockSize;
+  if (end > size_) end = size_;
+  for (Iterator it(*this, (low - 1) * kBlockSize); it.index() < end;
+       it.Advance()) {
+    if (it.current().compare(path) >= 0) return it.index();
+  }
+  return end;
+}
+
+bool PathList::Find(const std::string& path, size_t* index) const {
+  size_t position = LowerBound(path);
+  if (position == size_) return false;
+  Iterator it(*this, position);
+  if (it.current() != path) return false;
+  if (index != NULL) *index = position;
+  return true;
+}
+
+void PathList::PrefixRange(const std::string& prefix,
+                           size_t* begin,
+                           size_t* end) const {
+  *begin = LowerBound(prefix);
+
+  // Every path with the prefix sorts before the smallest string that is
+  // greater than all of them: the prefix with its last byte incremented,
+  // ignoring trailing 0xff bytes.
+  std::string limit = prefix;
+  while (!limit.empty() && static_cast<uint8_t>(*limit.rbegin()) == 0xff) {
+    limit.erase(limit.length() - 1);
+  }
+  if (limit.empty()) {
+    *end = size_;
+    return;
+  }
+  (*limit.rbegin())++;
+  *end = LowerBound(limit);
+}
+
+void PathList::Serialize(std::string* out) const {
+  out->append(kMagic, 4);
+  WriteUint64(kVersion, out);
+  WriteUint64(size_, out);
+  WriteUint64(kBlockSize, out);
+  WriteUint64(block_offsets_.size(), out);
+  for (size_t i = 0; i < block_offsets_.size(); i++) {
+    WriteUint64(block_offsets_[i], out);
+  }
+  WriteUint64(data_.length(), out);
+  out->append(data_);
+}
+
+bool PathList::Deserialize(const char* data, size_t length) {
+  data_.clear();
+  block_offsets_.clear();
+  size_ = 0;
+
+  size_t offset = 0;
+  uint64_t version, size, block_size, num_blocks, data_length;
+  if (length < 4 || memcmp(data, kMagic, 4) != 0) return false;
+  offset += 4;
+  if (!ReadUint64(data, length, &offset, &version) || version != kVersion) {
+    return false;
+  }
+  if (!ReadUint64(data, length, &offset, &size) ||
+      !ReadUint64(data, length, &offset, &block_size) ||
+      block_size != kBlockSize ||
+      !ReadUint64(data, length, &offset, &num_blocks) ||
+      num_blocks != size / kBlockSize + (size % kBlockSize != 0) ||
+      num_blocks > (length - offset) / 8) {
+    return false;
+  }
+  std::vector<uint64_t> block_offsets(num_blocks);
+  for (size_t i = 0; i < num_blocks; i++) {
+    if (!ReadUint64(data, length, &offset, &block_offsets[i])) return false;
+  }
+  if (!ReadUint64(data, length, &offset, &data_length) ||
+      data_length != length - offset) {
+    return false;
+  }
+  const char* encoded = data + offset;
+
+  // Check that every entry decodes within bounds so that lookups can skip
+  // the checks.
+  size_t position = 0;
+  uint64_t previous_length = 0;
+  for (uint64_t i = 0; i < size; i++) {
+    uint64_t shared = 0;
+    uint64_t suffix;
+    if (i % kBlockSize == 0) {
+      if (block_offsets[i / kBlockSize] != position) return false;
+    } else if (!ReadCheckedVarint(encoded, data_length, &position, &shared) ||
+               shared > previous_length) {
+      return false;
+    }
+    if (!ReadCheckedVarint(encoded, data_length, &position, &suffix) ||
+        suffix > data_length - position) {
+      return false;
+    }
+    position += suffix;
+    previous_length = shared + suffix;
+  }
+  if (position != data_length) return false;
+
+  data_.assign(encoded, data_length);
+  block_offsets_.swap(block_offsets);
+  size_ = size;
+  return true;
+}
+
+PathList::Iterator::Iterator(const PathList& list, size_t index)
+    : list_(list), index_(index), offset_(0) {
+  if (Done()) return;
+  size_t block = index / kBlockSize;
+  offset_ = list.block_offsets_[block];
+  index_ = block * kBlockSize;
+  Decode();
+  while (index_ < index) Advance();
+}
+
+void PathList::Iterator::Advance() {
+  index_++;
+  if (!Done()) Decode();
+}
+
+void PathList::Iterator::Decode() {
+  const char* data = list_.data_.data();
+  size_t shared = 0;
+  if (index_ % kBlockSize != 0) shared = ReadVarint(data, &offset_);
+  size_t suffix = ReadVarint(data, &offset_);
+  current_.resize(shared);
+  current_.append(data + offset_, suffix);
+  offset_ += suffix;
+}
+
+}  // namespace snapshotter
+}  // namespace dart
@@ -0,0 +1,94 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_PATH_LIST_H_
+#define SRC_NATIVE_SNAPSHOTTER_PATH_LIST_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "native/platform/globals.h"
+
+namespace dart {
+namespace snapshotter {
+
+// An immutable, sorted list of paths stored front-coded: each path is kept
+// as the length of the prefix it shares with the previous path followed by
+// the remaining suffix. Paths are grouped in blocks of kBlockSize, and the
+// first path of every block is stored in full so that a sparse index of
+// block offsets supports binary search without decoding the whole list.
+class PathList {
+ public:
+  static const size_t kBlockSize = 16;
+
+  PathList();
+
+  // Replaces the contents with |paths|, which must be sorted in ascending
+  // byte order.
+  void Build(const std::vector<std::string>& paths);
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Returns the path at |index|.
+  std::string Get(size_t index) const;
+
+  // Returns true if |path| is in the list, and sets |index| to its position
+  // if it is not NULL.
+  bool Find(const std::string& path, size_t* index) const;
+
+  // Returns the index of the first path that is not less than |path|.
+  size_t LowerBound(const std::string& path) const;
+
+  // Sets [|begin|, |end|) to the range of paths that start with |prefix|.
+  void PrefixRange(const std::string& prefix, size_t* begin, size_t* end) const;
+
+  // Appends the serialized form of the list to |out|.
+  void Serialize(std::string* out) const;
+
+  // Replaces the contents with the list serialized in |data|. Returns false,
+  // leaving the list empty, if |data| is not a valid serialized list.
+  bool Deserialize(const char* data, size_t length);
+
+  // The number of bytes used by the encoded paths.
+  size_t encoded_size() const { return data_.length(); }
+
+  // Decodes paths sequentially, starting at a given index.
+  class Iterator {
+   public:
+    Iterator(const PathList& list, size_t index);
+
+    bool Done() const { return index_ >= list_.size_; }
+    size_t index() const { return index_; }
+    const std::string& current() const { return current_; }
+    void Advance();
+
+   private:
+    void Decode();
+
+    const PathList& list_;
+    size_t index_;
+    size_t offset_;
+    std::string current_;
+
+    DISALLOW_COPY_AND_ASSIGN(Iterator);
+  };
+
+ private:
+  // Returns the first path of |block| without copying it.
+  const char* BlockHead(size_t block, size_t* length) const;
+
+  std::string data_;
+  std::vector<uint64_t> block_offsets_;
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(PathList);
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_PATH_LIST_H_
@@ -0,0 +1,129 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include <algorithm>
+#include <sstream>
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path_list.h"
+
+namespace dart {
+namespace snapshotter {
+
+static std::vector<std::string> SortedPaths(size_t count) {
+  std::vector<std::string> paths;
+  for (size_t i = 0; i < count; i++) {
+    std::stringstream path;
+    path << "/home/build/project/packages/pkg" << (i % 7) << "/lib/src/file"
+         << i << ".dart";
+    paths.push_back(path.str());
+  }
+  std::sort(paths.begin(), paths.end());
+  return paths;
+}
+
+void PathListLookupTests() {
+  std::vector<std::string> paths = SortedPaths(1000);
+  PathList list;
+  list.Build(paths);
+
+  EXPECT_EQ(list.size(), paths.size());
+  EXPECT(list.encoded_size() < paths.size() * paths[0].length() / 2);
+  for (size_t i = 0; i < paths.size(); i++) {
+    EXPECT_EQ(list.Get(i), paths[i]);
+    size_t index = 0;
+    EXPECT(list.Find(paths[i], &index));
+    EXPECT_EQ(index, i);
+  }
+  EXPECT(!list.Find("", NULL));
+  EXPECT(!list.Find("/home/build/project/packages/pkg0", NULL));
+  EXPECT(!list.Find("/zzz", NULL));
+  EXPECT_EQ(list.LowerBound(""), 0u);
+  EXPECT_EQ(list.LowerBound("/zzz"), paths.size());
+
+  size_t i = 0;
+  for (PathList::Iterator it(list, 0); !it.Done(); it.Advance(), i++) {
+    EXPECT_EQ(it.current(), paths[i]);
+  }
+  EXPECT_EQ(i, paths.size());
+
+  PathList empty;
+  empty.Build(std::vector<std::string>());
+  EXPECT(empty.empty());
+  EXPECT(!empty.Find("a", NULL));
+}
+
+void PathListPrefixRangeTests() {
+  std::vector<std::string> paths = SortedPaths(500);
+  PathList list;
+  list.Build(paths);
+
+  const char* prefixes[] = {
+    "", "/", "/home/build/project/packages/pkg3/", "/home/build/project/x",
+    "/home/build/project/packages/pkg6/lib/src/file4",
+  };
+  for (size_t p = 0; p < ARRAY_SIZE(prefixes); p++) {
+    std::string prefix = prefixes[p];
+    size_t begin, end;
+    list.PrefixRange(prefix, &begin, &end);
+    size_t expected_begin = paths.size();
+    size_t expected_end = 0;
+    for (size_t i = 0; i < paths.size(); i++) {
+      if (paths[i].compare(0, prefix.length(), prefix) == 0) {
+        if (expected_begin == paths.size()) expected_begin = i;
+        expected_end = i + 1;
+      }
+    }
+    if (expected_end == 0) {
+      EXPECT_EQ(begin, end);
+    } else {
+      EXPECT_EQ(begin, expected_begin);
+      EXPECT_EQ(end, expected_end);
+    }
+  }
+}
+
+void PathListSerializeTests() {
+  std::vector<std::string> paths = SortedPaths(100);
+  PathList list;
+  list.Build(paths);
+  std::string data;
+  list.Serialize(&data);
+
+  PathList loaded;
+  EXPECT(loaded.Deserialize(data.data(), data.length()));
+  EXPECT_EQ(loaded.size(), paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    EXPECT_EQ(loaded.Get(i), paths[i]);
+  }
+
+  // Truncated and corrupted input is rejected.
+  EXPECT(!loaded.Deserialize(data.data(), data.length() - 1));
+  EXPECT(loaded.empty());
+  EXPECT(!loaded.Deserialize(data.data(), 3));
+  std::string corrupt = data;
+  size_t encoded_start = data.length() - list.encoded_size();
+  corrupt[encoded_start] = '\x7f';
+  EXPECT(!loaded.Deserialize(corrupt.data(), corrupt.length()));
+
+  // A size so large that rounding it up to whole blocks would overflow.
+  PathList empty;
+  std::string huge;
+  empty.Serialize(&huge);
+  EXPECT(loaded.Deserialize(huge.data(), huge.length()));
+  const size_t kSizeOffset = 12;
+  for (size_t i = 0; i < 8; i++) huge[kSizeOffset + i] = '\xff';
+  EXPECT(!loaded.Deserialize(huge.data(), huge.length()));
+  EXPECT(loaded.empty());
+}
+
+extern void ExecutePathListTests() {
+  PathListLookupTests();
+  PathListPrefixRangeTests();
+  PathListSerializeTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
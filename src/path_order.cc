@@ -0,0 +1,192 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/path_order.h"
+
+#include "native/platform/assert.h"
+#include "native/snapshotter/path_parallel.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <thread>
+
+namespace dart {
+namespace snapshotter {
+
+// The fewest paths Sort gives each thread to sort before merging.
+static const size_t kMinPathsPerChunk = 4096;
+
+// Yields the root of a path, if it has one, followed by its components.
+class ComponentCursor {
+ public:
+  ComponentCursor(const PathStyle& style, const char* data, size_t length)
+      : it_(style, data, length),
+        data_(data),
+        root_pending_(it_.root_length() > 0),
+        component_(NULL),
+        length_(0) {}
+
+  bool Next() {
+    if (root_pending_) {
+      root_pending_ = false;
+      component_ = data_;
+      length_ = it_.root_length();
+      return true;
+    }
+    if (!it_.Next()) return false;
+    component_ = it_.component();
+    length_ = it_.component_length();
+    return true;
+  }
+
+  const char* component() const { return component_; }
+  size_t length() const { return length_; }
+
+ private:
+  PathComponentIterator it_;
+  const char* data_;
+  bool root_pending_;
+  const char* component_;
+  size_t length_;
+
+  DISALLOW_COPY_AND_ASSIGN(ComponentCursor);
+};
+
+int PathOrder::Compare(const Path& path,
+                       const char* a,
+                       size_t a_length,
+                       const char* b,
+                       size_t b_length) {
+  ComponentCursor a_cursor(path.style(), a, a_length);
+  ComponentCursor b_cursor(path.style(), b, b_length);
+  while (true) {
+    bool a_more = a_cursor.Next();
+    bool b_more = b_cursor.Next();
+    if (!a_more || !b_more) {
+      return static_cast<int>(a_more) - static_cast<int>(b_more);
+    }
+    size_t length = std::min(a_cursor.length(), b_cursor.length());
+    int result = length == 0 ?
+        0 : memcmp(a_cursor.component(), b_cursor.component(), length);
+    if (result != 0) return result;
+    if (a_cursor.length() != b_cursor.length()) {
+      return a_cursor.length() < b_cursor.length() ? -1 : 1;
+    }
+  }
+}
+
+uint64_t PathOrder::SortKey(const Path& path, const char* data, size_t length) {
+  uint64_t key = 0;
+  int filled = 0;
+  ComponentCursor cursor(path.style(), data, length);
+  while (filled < 8 && cursor.Next()) {
+    for (size_t i = 0; i < cursor.length() && filled < 8; i++, filled++) {
+      key = (key << 8) | static_cast<uint8_t>(cursor.component()[i]);
+    }
+    if (filled < 8) {
+      key <<= 8;
+      filled++;
+    }
+  }
+  return filled < 8 ? key << (8 * (8 - filled)) : key;
+}
+
+namespace {
+
+struct SortEntry {
+  uint64_t key;
+  size_t index;
+};
+
+class SortEntryLess {
+ public:
+  SortEntryLess(const Path& path, const std::vector<std::string>& paths)
+      : path_(&path), paths_(&paths) {}
+
+  bool operator()(const SortEntry& a, const SortEntry& b) const {
+    if (a.key != b.key) return a.key < b.key;
+    int result = PathOrder::Compare(*path_, (*paths_)[a.index],
+                                    (*paths_)[b.index]);
+    if (result != 0) return result < 0;
+    return a.index < b.index;
+  }
+
+ private:
+  const Path* path_;
+  const std::vector<std::string>* paths_;
+};
+
+void MergeRanges(SortEntry* begin,
+                 SortEntry* middle,
+                 SortEntry* end,
+                 SortEntry* out,
+                 SortEntryLess less) {
+  std::merge(begin, middle, middle, end, out, less);
+}
+
+}  // namespace
+
+void PathOrder::Sort(const Path& path,
+                     std::vector<std::string>* paths,
+                     int num_threads) {
+  size_t count = paths->size();
+  if (count < 2) return;
+  size_t num_chunks =
+      PathParallel::NumChunks(count, kMinPathsPerChunk, num_threads);
+
+  // Sort (key, index) pairs, so most comparisons are a single integer
+  // compare and the strings themselves are only moved once.
+  std::vector<SortEntry> entries(count);
+  for (size_t i = 0; i < count; i++) {
+    const std::string& p = (*paths)[i];
+    entries[i].key = SortKey(path, p.data(), p.length());
+    entries[i].index = i;
+  }
+  SortEntryLess less(path, *paths);
+
+  PathParallel::ForEachChunk(count, num_chunks,
+                             [&](size_t chunk, size_t start, size_t end) {
+    std::sort(&entries[0] + start, &entries[0] + end, less);
+  });
+
+  std::vector<size_t> bounds(num_chunks + 1);
+  for (size_t i = 0; i <= num_chunks; i++) {
+    bounds[i] = PathParallel::ChunkStart(count, num_chunks, i);
+  }
+  std::vector<std::thread> threads;
+
+  // Merge neighbouring runs in parallel until one is left.
+  std::vector<SortEntry> buffer(count);
+  SortEntry* from = &entries[0];
+  SortEntry* to = &buffer[0];
+  while (bounds.size() > 2) {
+    threads.clear();
+    std::vector<size_t> merged;
+    for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+      merged.push_back(bounds[i]);
+      if (i + 2 < bounds.size()) {
+        threads.push_back(std::thread(MergeRanges, from + bounds[i],
+                                      from + bounds[i + 1],
+                                      from + bounds[i + 2],
+                                      to + bounds[i], less));
+      } else {
+        std::copy(from + bounds[i], from + bounds[i + 1], to + bounds[i]);
+      }
+    }
+    merged.push_back(count);
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+    bounds.swap(merged);
+    std::swap(from, to);
+  }
+
+  std::vector<std::string> sorted(count);
+  for (size_t i = 0; i < count; i++) {
+    sorted[i].swap((*paths)[from[i].index]);
+  }
+  paths->swap(sorted);
+}
+
+}  // namespace snapshotter
+}  // namespace dart
@@ -0,0 +1,70 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_PATH_ORDER_H_
+#define SRC_NATIVE_SNAPSHOTTER_PATH_ORDER_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "native/platform/globals.h"
+#include "native/snapshotter/path.h"
+
+namespace dart {
+namespace snapshotter {
+
+// Orders paths component by component: by the lexicographic order of their
+// Path::Split results, with components compared byte by byte. Unlike plain
+// string order this keeps the contents of a directory together, so "a/b"
+// sorts before "a-b/c", and redundant separators are ignored.
+class PathOrder {
+ public:
+  // Returns a negative number, zero or a positive number if |a| orders
+  // before, the same as, or after |b| in the style of |path|. Does not
+  // allocate.
+  static int Compare(const Path& path,
+                     const char* a,
+                     size_t a_length,
+                     const char* b,
+                     size_t b_length);
+  static int Compare(const Path& path,
+                     const std::string& a,
+                     const std::string& b) {
+    return Compare(path, a.data(), a.length(), b.data(), b.length());
+  }
+
+  // A comparator for standard containers and algorithms.
+  class Less {
+   public:
+    explicit Less(const Path& path) : path_(&path) {}
+    bool operator()(const std::string& a, const std::string& b) const {
+      return Compare(*path_, a, b) < 0;
+    }
+
+   private:
+    const Path* path_;
+  };
+
+  // Returns the first eight bytes of the component encoding of |path|, in
+  // which each component, the root first, is followed by a zero byte. The
+  // encodings order like Compare, so for paths without NUL bytes the keys
+  // order like their paths whenever they differ.
+  static uint64_t SortKey(const Path& path, const char* data, size_t length);
+
+  // Sorts |paths| in place, on up to |num_threads| threads; zero picks a
+  // thread count based on the hardware. The sort is stable.
+  static void Sort(const Path& path,
+                   std::vector<std::string>* paths,
+                   int num_threads = 0);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(PathOrder);
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_PATH_ORDER_H_
@@ -0,0 +1,87 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include <algorithm>
+#include <sstream>
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path.h"
+#include "native/snapshotter/path_order.h"
+
+namespace dart {
+namespace snapshotter {
+
+static int Sign(int value) {
+  return value < 0 ? -1 : (value > 0 ? 1 : 0);
+}
+
+static bool SplitLess(const Path& path,
+                      const std::string& a,
+                      const std::string& b) {
+  return path.Split(a) < path.Split(b);
+}
+
+void PathOrderCompareTests() {
+  const Path& path = Path::kPosix;
+  EXPECT(PathOrder::Compare(path, "a/b", "a-b/c") < 0);
+  EXPECT(PathOrder::Compare(path, "a-b/c", "a/b") > 0);
+  EXPECT(PathOrder::Compare(path, "a/b", "a//b/") == 0);
+  EXPECT(PathOrder::Compare(path, "a", "a/b") < 0);
+  EXPECT(PathOrder::Compare(path, "ab", "a/b") > 0);
+  EXPECT(PathOrder::Compare(path, "", "a") < 0);
+  EXPECT(PathOrder::Compare(Path::kWindows, "a\\b", "a/b") == 0);
+  EXPECT(PathOrder::Compare(Path::kWindows, "a\\b", "a-b") < 0);
+
+  const char* inputs[] = {
+    "", "a", "a/b", "a-b/c", "a.b", "ab", "/a", "/", "//a", "a\\b",
+    "C:\\a", "c:/a", "\\\\s\\t\\u", "http://a.org/b", "file:///c",
+  };
+  const Path* styles[] = { &Path::kPosix, &Path::kWindows, &Path::kUrl };
+  for (size_t s = 0; s < ARRAY_SIZE(styles); s++) {
+    const Path& style = *styles[s];
+    for (size_t i = 0; i < ARRAY_SIZE(inputs); i++) {
+      for (size_t j = 0; j < ARRAY_SIZE(inputs); j++) {
+        std::vector<std::string> a = style.Split(inputs[i]);
+        std::vector<std::string> b = style.Split(inputs[j]);
+        int expected = a < b ? -1 : (b < a ? 1 : 0);
+        EXPECT_EQ(Sign(PathOrder::Compare(style, inputs[i], inputs[j])),
+            expected);
+      }
+    }
+  }
+}
+
+void PathOrderSortTests() {
+  std::vector<std::string> paths;
+  for (int i = 0; i < 30000; i++) {
+    std::stringstream path;
+    path << "pkg" << (i * 7919 % 23) << ((i % 3) ? "/" : "-x/") << "lib"
+         << ((i % 5) ? "/" : "//") << (i * 7907 % 1000);
+    paths.push_back(path.str());
+  }
+  std::vector<std::string> expected = paths;
+  std::stable_sort(expected.begin(), expected.end(),
+                   PathOrder::Less(Path::kPosix));
+
+  std::vector<std::string> sorted = paths;
+  PathOrder::Sort(Path::kPosix, &sorted, 4);
+  EXPECT(sorted == expected);
+
+  sorted = paths;
+  PathOrder::Sort(Path::kPosix, &sorted, 1);
+  EXPECT(sorted == expected);
+
+  for (size_t i = 1; i < 1000; i++) {
+    EXPECT(!SplitLess(Path::kPosix, sorted[i], sorted[i - 1]));
+  }
+}
+
+extern void ExecutePathOrderTests() {
+  PathOrderCompareTests();
+  PathOrderSortTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
@@ -0,0 +1,75 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_PATH_PARALLEL_H_
+#define SRC_NATIVE_SNAPSHOTTER_PATH_PARALLEL_H_
+
+#include <thread>
+#include <vector>
+
+#include "native/platform/globals.h"
+
+namespace dart {
+namespace snapshotter {
+
+// Splits the bulk path operations into contiguous chunks of their input and
+// runs the chunks on threads.
+//
+// Starting a thread costs tens of microseconds, so each operation sets the
+// fewest items a chunk must have to be worth one. For work that is bound by
+// the CPU this is thousands of paths. Work that waits on the disk needs far
+// fewer. Inputs below that size run on the calling thread alone.
+class PathParallel {
+ public:
+  // Returns |num_threads| if it is positive, and one per core otherwise.
+  static size_t NumThreads(int num_threads) {
+    if (num_threads > 0) return num_threads;
+    size_t cores = std::thread::hardware_concurrency();
+    return cores > 0 ? cores : 1;
+  }
+
+  // Returns how many chunks to split |count| items into so that each has at
+  // least |min_per_chunk| of them, with no more chunks than
+  // NumThreads(|num_threads|). Always returns at least one.
+  static size_t NumChunks(size_t count,
+                          size_t min_per_chunk,
+                          int num_threads) {
+    size_t num_chunks = count / min_per_chunk;
+    size_t max_chunks = NumThreads(num_threads);
+    if (num_chunks > max_chunks) num_chunks = max_chunks;
+    return num_chunks > 0 ? num_chunks : 1;
+  }
+
+  // Returns the first item of chunk |index| when |count| items are split
+  // into |num_chunks| chunks that differ in size by at most one. Chunk
+  // |index| ends where chunk |index| + 1 starts, and the last one at
+  // |count|.
+  static size_t ChunkStart(size_t count, size_t num_chunks, size_t index) {
+    return count * index / num_chunks;
+  }
+
+  // Calls |body(index, start, end)| for each of the |num_chunks| chunks of
+  // |count| items. Each chunk but the last runs on a thread of its own, and
+  // the last runs on the calling thread. Returns once they are all done.
+  template <typename Body>
+  static void ForEachChunk(size_t count, size_t num_chunks, Body body) {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i + 1 < num_chunks; i++) {
+      threads.push_back(std::thread(body, i,
+                                    ChunkStart(count, num_chunks, i),
+                                    ChunkStart(count, num_chunks, i + 1)));
+    }
+    body(num_chunks - 1, ChunkStart(count, num_chunks, num_chunks - 1),
+         count);
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+  }
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(PathParallel);
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_PATH_PARALLEL_H_
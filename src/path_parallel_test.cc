@@ -0,0 +1,53 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path_parallel.h"
+
+#include <vector>
+
+namespace dart {
+namespace snapshotter {
+
+void PathParallelChunkTests() {
+  EXPECT_EQ(PathParallel::NumThreads(3), 3u);
+  EXPECT(PathParallel::NumThreads(0) >= 1u);
+
+  EXPECT_EQ(PathParallel::NumChunks(0, 100, 4), 1u);
+  EXPECT_EQ(PathParallel::NumChunks(199, 100, 4), 1u);
+  EXPECT_EQ(PathParallel::NumChunks(200, 100, 4), 2u);
+  EXPECT_EQ(PathParallel::NumChunks(100000, 100, 4), 4u);
+  EXPECT_EQ(PathParallel::NumChunks(100000, 100, 1), 1u);
+
+  EXPECT_EQ(PathParallel::ChunkStart(10, 3, 0), 0u);
+  EXPECT_EQ(PathParallel::ChunkStart(10, 3, 1), 3u);
+  EXPECT_EQ(PathParallel::ChunkStart(10, 3, 2), 6u);
+  EXPECT_EQ(PathParallel::ChunkStart(10, 3, 3), 10u);
+}
+
+void PathParallelForEachTests() {
+  const size_t kCount = 1000;
+  for (size_t num_chunks = 1; num_chunks <= 4; num_chunks++) {
+    std::vector<int> visits(kCount, 0);
+    std::vector<size_t> starts(num_chunks, kCount);
+    PathParallel::ForEachChunk(kCount, num_chunks,
+                               [&](size_t chunk, size_t start, size_t end) {
+      starts[chunk] = start;
+      for (size_t i = start; i < end; i++) visits[i]++;
+    });
+    for (size_t i = 0; i < kCount; i++) EXPECT_EQ(visits[i], 1);
+    for (size_t i = 0; i < num_chunks; i++) {
+      EXPECT_EQ(starts[i], PathParallel::ChunkStart(kCount, num_chunks, i));
+    }
+  }
+}
+
+extern void ExecutePathParallelTests() {
+  PathParallelChunkTests();
+  PathParallelForEachTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
@@ -0,0 +1,141 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/path_replay.h"
+
+#include "native/platform/assert.h"
+
+#include <inttypes.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace dart {
+namespace snapshotter {
+
+// Makes the call in |record|, and returns something derived from its
+// result so that it cannot be optimized away.
+static size_t Execute(const PathTraceRecord& record) {
+  const Path& path = *record.path;
+  const std::vector<std::string>& arguments = record.arguments;
+  static const std::string kEmpty;
+  const std::string& first = arguments.empty() ? kEmpty : arguments[0];
+  switch (record.operation) {
+    case kPathIsAbsolute:
+      return path.IsAbsolute(first);
+    case kPathRootPrefix:
+      return path.RootPrefix(first).length();
+    case kPathDirname:
+      return path.Dirname(first).length();
+    case kPathNormalize:
+      return path.Normalize(first).length();
+    case kPathIsNormalized:
+      return path.IsNormalized(first);
+    case kPathJoinAll:
+      return path.JoinAll(arguments).length();
+    case kPathSplit:
+      return path.Split(first).size();
+    case kPathCommonAncestor:
+      return path.CommonAncestor(arguments).length();
+    case kPathIsWithin:
+      return path.IsWithin(first,
+                           arguments.size() > 1 ? arguments[1] : kEmpty);
+    case kPathConvertTo: {
+      std::string result;
+      const Path& target = record.target != NULL ? *record.target : path;
+      path.ConvertTo(target, first.data(), first.length(), &result);
+      return result.length();
+    }
+    case kNumPathOperations:
+      break;
+  }
+  UNREACHABLE();
+  return 0;
+}
+
+// The latency below which |fraction| of |sorted| falls.
+static int64_t Percentile(const std::vector<int64_t>& sorted,
+                          double fraction) {
+  size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+  return sorted[index];
+}
+
+bool PathReplay::Load(PathTraceReader* reader,
+                      std::vector<PathTraceRecord>* records) {
+  records->clear();
+  PathTraceRecord record;
+  while (reader->Next(&record)) records->push_back(record);
+  return !reader->error();
+}
+
+void PathReplay::Run(const std::vector<PathTraceRecord>& records,
+                     int iterations,
+                     std::vector<PathReplayStats>* stats) {
+  typedef std::chrono::steady_clock Clock;
+  std::vector<std::vector<const PathTraceRecord*> > batches(
+      kNumPathOperations);
+  for (size_t i = 0; i < records.size(); i++) {
+    batches[records[i].operation].push_back(&records[i]);
+  }
+  std::vector<int64_t> totals(kNumPathOperations, 0);
+  std::vector<std::vector<int64_t> > latencies(kNumPathOperations);
+  for (int operation = 0; operation < kNumPathOperations; operation++) {
+    latencies[operation].reserve(batches[operation].size() * iterations);
+  }
+  volatile size_t sink = 0;
+  for (int iteration = 0; iteration < iterations; iteration++) {
+    for (int operation = 0; operation < kNumPathOperations; operation++) {
+      const std::vector<const PathTraceRecord*>& batch = batches[operation];
+      if (batch.empty()) continue;
+      Clock::time_point start = Clock::now();
+      for (size_t i = 0; i < batch.size(); i++) {
+        sink = sink + Execute(*batch[i]);
+      }
+      totals[operation] += std::chrono::duration_cast<
+          std::chrono::nanoseconds>(Clock::now() - start).count();
+
+      for (size_t i = 0; i < batch.size(); i++) {
+        Clock::time_point call_start = Clock::now();
+        sink = sink + Execute(*batch[i]);
+        Clock::time_point call_end = Clock::now();
+        latencies[operation].push_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                call_end - call_start).count());
+      }
+    }
+  }
+
+  stats->clear();
+  for (int operation = 0; operation < kNumPathOperations; operation++) {
+    std::vector<int64_t>& times = latencies[operation];
+    if (times.empty()) continue;
+    std::sort(times.begin(), times.end());
+    PathReplayStats entry;
+    entry.operation = static_cast<PathOperation>(operation);
+    entry.calls = times.size();
+    entry.total = totals[operation];
+    entry.p50 = Percentile(times, 0.5);
+    entry.p90 = Percentile(times, 0.9);
+    entry.p99 = Percentile(times, 0.99);
+    entry.max = times.back();
+    stats->push_back(entry);
+  }
+}
+
+void PathReplay::Print(const std::vector<PathReplayStats>& stats, FILE* out) {
+  fprintf(out, "%-16s %10s %14s %8s %8s %8s %10s\n", "operation", "calls",
+          "calls/s", "p50 ns", "p90 ns", "p99 ns", "max ns");
+  for (size_t i = 0; i < stats.size(); i++) {
+    const PathReplayStats& entry = stats[i];
+    double seconds = entry.total / 1e9;
+    double throughput = seconds > 0 ? entry.calls / seconds : 0;
+    fprintf(out, "%-16s %10" PRIu64 " %14.0f %8" PRId64 " %8" PRId64
+            " %8" PRId64 " %10" PRId64 "\n",
+            PathOperationName(entry.operation), entry.calls, throughput,
+            entry.p50, entry.p90, entry.p99, entry.max);
+  }
+}
+
+}  // namespace snapshotter
+}  // namespace dart
@@ -0,0 +1,59 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_PATH_REPLAY_H_
+#define SRC_NATIVE_SNAPSHOTTER_PATH_REPLAY_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <vector>
+
+#include "native/platform/globals.h"
+#include "native/snapshotter/path_trace.h"
+
+namespace dart {
+namespace snapshotter {
+
+// How one operation performed over a replay. Times are in nanoseconds.
+// |total| is measured over whole batches of calls, and the percentiles over
+// single calls, so they include the cost of reading the clock.
+struct PathReplayStats {
+  PathOperation operation;
+  uint64_t calls;
+  int64_t total;
+  int64_t p50;
+  int64_t p90;
+  int64_t p99;
+  int64_t max;
+};
+
+// Replays a trace recorded by PathRecorder against the library, to
+// reproduce a production workload locally or compare library versions.
+class PathReplay {
+ public:
+  // Reads every record of |reader|. Returns false if the trace is
+  // malformed.
+  static bool Load(PathTraceReader* reader,
+                   std::vector<PathTraceRecord>* records);
+
+  // Makes the calls in |records| |iterations| times over, and stores the
+  // stats of each operation that was called, in PathOperation order. Each
+  // iteration makes the calls of one operation back to back, first timed as
+  // a batch for throughput and then one by one for latency.
+  static void Run(const std::vector<PathTraceRecord>& records,
+                  int iterations,
+                  std::vector<PathReplayStats>* stats);
+
+  // Prints |stats| as a table, with throughput in calls per second.
+  static void Print(const std::vector<PathReplayStats>& stats, FILE* out);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(PathReplay);
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_PATH_REPLAY_H_
@@ -0,0 +1,42 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Replays a Path trace and reports throughput and latency per operation:
+//
+//   path_replay <trace> [iterations]
+
+#include "native/snapshotter/path_replay.h"
+#include "native/snapshotter/path_trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using dart::snapshotter::PathReplay;
+using dart::snapshotter::PathReplayStats;
+using dart::snapshotter::PathTraceReader;
+using dart::snapshotter::PathTraceRecord;
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "Usage: %s <trace> [iterations]\n", argv[0]);
+    return 2;
+  }
+  int iterations = argc > 2 ? atoi(argv[2]) : 1;
+  if (iterations <= 0) {
+    fprintf(stderr, "Invalid iteration count: %s\n", argv[2]);
+    return 2;
+  }
+
+  PathTraceReader reader;
+  std::vector<PathTraceRecord> records;
+  if (!reader.Open(argv[1]) || !PathReplay::Load(&reader, &records)) {
+    fprintf(stderr, "Could not read trace: %s\n", argv[1]);
+    return 1;
+  }
+  std::vector<PathReplayStats> stats;
+  PathReplay::Run(records, iterations, &stats);
+  printf("%zu calls, %d iterations\n", records.size(), iterations);
+  PathReplay::Print(stats, stdout);
+  return 0;
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path.h"
+#include "native/snapshotter/path_replay.h"
+#include "native/snapshotter/path_trace.h"
+
+namespace dart {
+namespace snapshotter {
+
+static PathTraceRecord Record(PathOperation operation,
+                              const Path& path,
+                              const std::string& argument) {
+  PathTraceRecord record;
+  record.operation = operation;
+  record.path = &path;
+  record.target = NULL;
+  record.arguments.push_back(argument);
+  return record;
+}
+
+void PathReplayTests() {
+  std::vector<PathTraceRecord> records;
+  for (int i = 0; i < 10; i++) {
+    records.push_back(Record(kPathNormalize, Path::kPosix, "/a/b/../c"));
+    records.push_back(Record(kPathDirname, Path::kPosix, "/a/b/c"));
+  }
+  records.push_back(Record(kPathConvertTo, Path::kWindows, "C:\\a"));
+  records.back().target = &Path::kPosix;
+  records.push_back(Record(kPathCommonAncestor, Path::kPosix, "/a/b"));
+  records.back().arguments.push_back("/a/c");
+
+  std::vector<PathReplayStats> stats;
+  PathReplay::Run(records, 3, &stats);
+  EXPECT_EQ(stats.size(), 4u);
+  EXPECT_EQ(stats[0].operation, kPathDirname);
+  EXPECT_EQ(stats[0].calls, 30u);
+  EXPECT_EQ(stats[1].operation, kPathNormalize);
+  EXPECT_EQ(stats[1].calls, 30u);
+  EXPECT_EQ(stats[2].operation, kPathCommonAncestor);
+  EXPECT_EQ(stats[2].calls, 3u);
+  EXPECT_EQ(stats[3].operation, kPathConvertTo);
+  for (size_t i = 0; i < stats.size(); i++) {
+    EXPECT(stats[i].p50 <= stats[i].p90);
+    EXPECT(stats[i].p90 <= stats[i].p99);
+    EXPECT(stats[i].p99 <= stats[i].max);
+  }
+
+  // A trace is loaded record by record, and a truncated one is rejected.
+  PathTraceReader reader;
+  EXPECT(reader.Init("PTRC\x01\x03\x00\x01\x02" "ab", 11));
+  EXPECT(PathReplay::Load(&reader, &records));
+  EXPECT_EQ(records.size(), 1u);
+  EXPECT_EQ(records[0].operation, kPathNormalize);
+  EXPECT(reader.Init("PTRC\x01\x03\x00\x05", 8));
+  EXPECT(!PathReplay::Load(&reader, &records));
+}
+
+extern void ExecutePathReplayTests() {
+  PathReplayTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
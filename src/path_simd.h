@@ -0,0 +1,198 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_PATH_SIMD_H_
+#define SRC_NATIVE_SNAPSHOTTER_PATH_SIMD_H_
+
+#include <stdint.h>
+
+#include "native/platform/globals.h"
+
+#if defined(HOST_ARCH_X64) || defined(HOST_ARCH_IA32)
+#include <emmintrin.h>
+#define PATH_SIMD_SSE2 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace dart {
+namespace snapshotter {
+
+// Byte scanning helpers shared by the bulk path operations. They process 16
+// bytes at a time with SSE2 where available and fall back to plain loops
+// elsewhere.
+class PathSimd {
+ public:
+  // Returns the index of the first byte equal to |a| or |b|, or |length| if
+  // there is none.
+  static size_t FindEither(const char* data, size_t length, char a, char b) {
+    size_t i = 0;
+#if defined(PATH_SIMD_SSE2)
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    for (; i + 16 <= length; i += 16) {
+      __m128i chunk =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+      int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, va),
+                                                _mm_cmpeq_epi8(chunk, vb)));
+      if (mask != 0) return i + CountTrailingZeros(mask);
+    }
+#endif
+    for (; i < length; i++) {
+      if (data[i] == a || data[i] == b) return i;
+    }
+    return length;
+  }
+
+  static size_t Find(const char* data, size_t length, char c) {
+    return FindEither(data, length, c, c);
+  }
+
+  // Returns the index of the first ASCII control character, a byte below
+  // 0x20, or |length| if there is none.
+  static size_t FindControl(const char* data, size_t length) {
+    size_t i = 0;
+#if defined(PATH_SIMD_SSE2)
+    const __m128i limit = _mm_set1_epi8(0x1f);
+    for (; i + 16 <= length; i += 16) {
+      __m128i chunk =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+      // Unsigned chunk <= 0x1f.
+      __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(chunk, limit), limit);
+      int mask = _mm_movemask_epi8(control);
+      if (mask != 0) return i + CountTrailingZeros(mask);
+    }
+#endif
+    for (; i < length; i++) {
+      if (static_cast<uint8_t>(data[i]) < 0x20) return i;
+    }
+    return length;
+  }
+
+  // Replaces each byte of |data| equal to |a| or |b| with |replacement|.
+  static void ReplaceEither(char* data,
+                            size_t length,
+                            char a,
+                            char b,
+                            char replacement) {
+    size_t i = 0;
+#if defined(PATH_SIMD_SSE2)
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    const __m128i vreplacement = _mm_set1_epi8(replacement);
+    for (; i + 16 <= length; i += 16) {
+      __m128i* address = reinterpret_cast<__m128i*>(data + i);
+      __m128i chunk = _mm_loadu_si128(address);
+      __m128i match = _mm_or_si128(_mm_cmpeq_epi8(chunk, va),
+                                   _mm_cmpeq_epi8(chunk, vb));
+      if (_mm_movemask_epi8(match) == 0) continue;
+      _mm_storeu_si128(address,
+                       _mm_or_si128(_mm_and_si128(match, vreplacement),
+                                    _mm_andnot_si128(match, chunk)));
+    }
+#endif
+    for (; i < length; i++) {
+      if (data[i] == a || data[i] == b) data[i] = replacement;
+    }
+  }
+
+  // Returns the length of the common prefix of |a| and |b|, which both have
+  // at least |length| bytes. If |either_slash| is true, '/' and '\' are
+  // considered equal, as they are for Windows paths.
+  static size_t CommonPrefixLength(const char* a,
+                                   const char* b,
+                                   size_t length,
+                                   bool either_slash) {
+    size_t i = 0;
+#if defined(PATH_SIMD_SSE2)
+    const __m128i slash = _mm_set1_epi8('/');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for (; i + 16 <= length; i += 16) {
+      __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+      __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+      __m128i equal = _mm_cmpeq_epi8(va, vb);
+      if (either_slash) {
+        __m128i a_separator = _mm_or_si128(_mm_cmpeq_epi8(va, slash),
+                                           _mm_cmpeq_epi8(va, backslash));
+        __m128i b_separator = _mm_or_si128(_mm_cmpeq_epi8(vb, slash),
+                                           _mm_cmpeq_epi8(vb, backslash));
+        equal = _mm_or_si128(equal, _mm_and_si128(a_separator, b_separator));
+      }
+      int mask = _mm_movemask_epi8(equal) ^ 0xffff;
+      if (mask != 0) return i + CountTrailingZeros(mask);
+    }
+#endif
+    for (; i < length; i++) {
+      if (a[i] == b[i]) continue;
+      if (either_slash && IsSlash(a[i]) && IsSlash(b[i])) continue;
+      return i;
+    }
+    return length;
+  }
+
+  // Widens the bytes of |data| into |out| for as long as whole blocks of 16
+  // are ASCII, and returns how many were converted. The rest, starting at
+  // the first block with a byte of 0x80 or above, is left to the caller.
+  static size_t WidenAscii(const char* data, size_t length, char16_t* out) {
+    size_t i = 0;
+#if defined(PATH_SIMD_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16) {
+      __m128i chunk =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+      if (_mm_movemask_epi8(chunk) != 0) break;
+      __m128i* address = reinterpret_cast<__m128i*>(out + i);
+      _mm_storeu_si128(address, _mm_unpacklo_epi8(chunk, zero));
+      _mm_storeu_si128(address + 1, _mm_unpackhi_epi8(chunk, zero));
+    }
+#endif
+    return i;
+  }
+
+  // The reverse of WidenAscii: narrows the units of |data| into |out| for
+  // as long as whole blocks of 16 are below 0x80.
+  static size_t NarrowAscii(const char16_t* data, size_t length, char* out) {
+    size_t i = 0;
+#if defined(PATH_SIMD_SSE2)
+    const __m128i high = _mm_set1_epi16(static_cast<int16_t>(0xff80));
+    for (; i + 16 <= length; i += 16) {
+      const __m128i* address = reinterpret_cast<const __m128i*>(data + i);
+      __m128i low_half = _mm_loadu_si128(address);
+      __m128i high_half = _mm_loadu_si128(address + 1);
+      __m128i bits = _mm_and_si128(_mm_or_si128(low_half, high_half), high);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(bits, _mm_setzero_si128())) !=
+          0xffff) {
+        break;
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                       _mm_packus_epi16(low_half, high_half));
+    }
+#endif
+    return i;
+  }
+
+ private:
+  static bool IsSlash(char c) { return c == '/' || c == '\\'; }
+
+#if defined(PATH_SIMD_SSE2)
+  // Returns the index of the lowest set bit of |mask|, which is not zero.
+  static int CountTrailingZeros(int mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, static_cast<unsigned long>(mask));
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+  }
+#endif
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(PathSimd);
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_PATH_SIMD_H_
@@ -5,9 +5,12 @@
 #include "native/platform/globals.h"
 #include "native/platform/assert.h"
 #include "native/log.h"
+#include "native/snapshotter/allocation_counter.h"
 #include "native/snapshotter/path.h"
 #include "native/snapshotter/directory.h"
 
+#include <string.h>
+
 namespace dart {
 namespace snapshotter {
 
@@ -145,6 +148,23 @@ void PosixNormalizeTests() {
   EXPECT_EQ(path.Normalize("a/b///"), "a/b");
 }
 
+void PosixIsNormalizedTests() {
+  const Path& path = Path::kPosix;
+  const char* inputs[] = {
+    "", ".", "..", "../..", "../a", "a/..", "a", "a/b", "a/b/", "a//b", "./a",
+    "/", "/a", "/..", "//a", "a\\b", "a/./b"
+  };
+  for (size_t i = 0; i < ARRAY_SIZE(inputs); i++) {
+    EXPECT_EQ(path.IsNormalized(inputs[i]),
+        path.Normalize(inputs[i]) == inputs[i]);
+  }
+  EXPECT(Path::kWindows.IsNormalized("C:\\a"));
+  EXPECT(!Path::kWindows.IsNormalized("C:/a"));
+  EXPECT(!Path::kWindows.IsNormalized("C:\\a/b"));
+  EXPECT(Path::kUrl.IsNormalized("http://dartlang.org/a"));
+  EXPECT(!Path::kUrl.IsNormalized("http://dartlang.org/"));
+}
+
 void PosixJoinTests() {
   const Path& path = Path::kPosix;
    // allows up to eight parts
@@ -183,12 +203,201 @@ void PosixJoinTests() {
   EXPECT_EQ(path.Join("a", "b/"), "a/b/");
 }
 
+void PosixCommonAncestorTests() {
+  const Path& path = Path::kPosix;
+  std::vector<std::string> paths;
+  EXPECT_EQ(path.CommonAncestor(paths), "");
+
+  paths.push_back("/a/b/c/");
+  EXPECT_EQ(path.CommonAncestor(paths), "/a/b/c");
+  paths.push_back("/a/b/d");
+  EXPECT_EQ(path.CommonAncestor(paths), "/a/b");
+  paths.push_back("/a/bc");
+  EXPECT_EQ(path.CommonAncestor(paths), "/a");
+  paths.push_back("/x");
+  EXPECT_EQ(path.CommonAncestor(paths), "/");
+  paths.push_back("x");
+  EXPECT_EQ(path.CommonAncestor(paths), "");
+
+  paths.clear();
+  paths.push_back("a/b/");
+  paths.push_back("a/b");
+  paths.push_back("a/b//c");
+  EXPECT_EQ(path.CommonAncestor(paths), "a/b");
+  paths.push_back("b");
+  EXPECT_EQ(path.CommonAncestor(paths), ".");
+
+  // splits the scan across threads
+  paths.clear();
+  for (int i = 0; i < 100000; i++) {
+    paths.push_back(path.Join("/root/pkg", i % 7 == 0 ? "lib" : "libs",
+                              "file.dart"));
+  }
+  EXPECT_EQ(path.CommonAncestor(paths), "/root/pkg");
+  paths[99999] = "/root/other";
+  EXPECT_EQ(path.CommonAncestor(paths), "/root");
+}
+
+void PosixConvertToTests() {
+  const Path& path = Path::kPosix;
+  EXPECT_EQ(path.ConvertTo(Path::kPosix, "a//b/"), "a//b/");
+  EXPECT_EQ(path.ConvertTo(Path::kWindows, ""), "");
+  EXPECT_EQ(path.ConvertTo(Path::kWindows, "a/b//c/"), "a\\b\\\\c\\");
+  EXPECT_EQ(path.ConvertTo(Path::kWindows, "/a/b"), "\\a\\b");
+  EXPECT_EQ(path.ConvertTo(Path::kWindows, "/C:/a/b"), "C:\\a\\b");
+  EXPECT_EQ(path.ConvertTo(Path::kWindows, "/C:"), "C:\\");
+  EXPECT_EQ(path.ConvertTo(Path::kWindows, "/C:a"), "\\C:a");
+  EXPECT_EQ(path.ConvertTo(Path::kUrl, "a/b"), "a/b");
+  EXPECT_EQ(path.ConvertTo(Path::kUrl, "/"), "file:///");
+  EXPECT_EQ(path.ConvertTo(Path::kUrl, "//a/b"), "file://a/b");
+  EXPECT_EQ(path.ConvertTo(Path::kUrl, "///a/b"), "file:///a/b");
+  EXPECT_EQ(path.ConvertTo(Path::kWindows, "//a/b"), "\\\\a\\b");
+  EXPECT_EQ(path.ConvertTo(Path::kUrl, "/c:/a"), "file:///c:/a");
+
+  // replaces separators past the vectorized part
+  std::string long_path;
+  std::string expected;
+  for (int i = 0; i < 37; i++) {
+    long_path += "/abc";
+    expected += "\\abc";
+  }
+  EXPECT_EQ(path.ConvertTo(Path::kWindows, long_path), expected);
+
+  std::vector<std::string> paths;
+  paths.push_back("/a");
+  paths.push_back("b/c");
+  std::vector<std::string> results;
+  path.ConvertAllTo(Path::kWindows, paths, &results);
+  EXPECT_EQ(results.size(), 2u);
+  EXPECT_EQ(results[0], "\\a");
+  EXPECT_EQ(results[1], "b\\c");
+}
+
+void PosixIsWithinTests() {
+  const Path& path = Path::kPosix;
+  EXPECT(path.IsWithin("/root", "a"));
+  EXPECT(path.IsWithin("/root", "a/b/../c"));
+  EXPECT(path.IsWithin("/root", "./a/."));
+  EXPECT(path.IsWithin("/root/", "a/../b"));
+  EXPECT(path.IsWithin("/root", "/root/a"));
+  EXPECT(path.IsWithin("/root", "//root/./a"));
+  EXPECT(path.IsWithin("/a/../root", "/a/../root/b"));
+  EXPECT(path.IsWithin(".", "a"));
+  EXPECT(path.IsWithin("", "a"));
+  EXPECT(path.IsWithin("a/b", "c"));
+
+  EXPECT(!path.IsWithin("/root", ""));
+  EXPECT(!path.IsWithin("/root", "."));
+  EXPECT(!path.IsWithin("/root", "a/.."));
+  EXPECT(!path.IsWithin("/root", ".."));
+  EXPECT(!path.IsWithin("/root", "a/../../root/b"));
+  EXPECT(!path.IsWithin("/root", "/root"));
+  EXPECT(!path.IsWithin("/root", "/root/"));
+  EXPECT(!path.IsWithin("/root", "/rootb/a"));
+  EXPECT(!path.IsWithin("/root", "/other/a"));
+  EXPECT(!path.IsWithin("/root", "/root/a/../.."));
+  EXPECT(!path.IsWithin("/root", "/ROOT/a"));
+  EXPECT(!path.IsWithin("root", "/root/a"));
+  EXPECT(!path.IsWithin("/root", "root/a/../../.."));
+
+  // never claims a path is inside when Normalize puts it outside
+  const char* paths[] = {
+    "a", "a/..", "../a", "a/../..", "a/b/../../c", "/root/a", "/root/../a",
+    "/a/b", ".", "./a/./../b/.."
+  };
+  for (size_t i = 0; i < ARRAY_SIZE(paths); i++) {
+    if (!path.IsWithin("/root", paths[i])) continue;
+    std::string normalized = path.Normalize(path.Join("/root", paths[i]));
+    EXPECT_EQ(normalized.compare(0, 6, "/root/"), 0);
+  }
+}
+
+// Checks how often each operation allocates, given a path that is already
+// normalized, one that is not and splits into |messy_parts| parts, and a
+// relative path.
+void AllocationTests(const Path& path,
+                     const std::string& normal,
+                     const std::string& messy,
+                     size_t messy_parts,
+                     const std::string& relative) {
+  std::string result;
+  bool is_true;
+  std::vector<std::string> parts;
+  std::vector<std::string> paths;
+  paths.push_back(normal);
+  paths.push_back(messy);
+
+  EXPECT_ALLOCATIONS(0, is_true = path.IsAbsolute(normal));
+  EXPECT_ALLOCATIONS(0, is_true = path.IsWithin(normal, relative));
+  EXPECT_ALLOCATIONS(0, {
+    PathComponentIterator it(path.style(), messy.data(), messy.length());
+    while (it.Next()) {}
+  });
+  EXPECT_ALLOCATIONS(1, result = path.RootPrefix(normal));
+  EXPECT_ALLOCATIONS(1, result = path.Normalize(normal));
+  EXPECT_ALLOCATIONS(1, result = path.CommonAncestor(paths));
+  EXPECT_ALLOCATIONS(1, result = path.ConvertTo(Path::kPosix, normal));
+  EXPECT_ALLOCATIONS(1, result = path.Normalize(messy));
+  EXPECT_ALLOCATIONS(1, result = path.Dirname(normal));
+  EXPECT_ALLOCATIONS(1, result = path.Dirname(messy));
+  // One for the vector, and at most one for each of its strings.
+  EXPECT_ALLOCATIONS(1 + messy_parts, parts = path.Split(messy));
+  EXPECT_EQ(parts.size(), messy_parts);
+
+  // JoinAll builds its result through a stringstream.
+  EXPECT_ALLOCATIONS(6, result = path.Join(normal, relative));
+  (void)is_true;
+}
+
+// Inputs crafted to make path operations slow: they should take time and
+// memory linear in their length.
+void PosixLongPathTests() {
+  const Path& path = Path::kPosix;
+  const int kCount = 100000;
+  std::string doubles;
+  std::string expected;
+  for (int i = 0; i < kCount; i++) {
+    doubles += "../";
+    if (i > 0) expected += "/";
+    expected += "..";
+  }
+  std::string result;
+  EXPECT_ALLOCATIONS(1, result = path.Normalize(doubles));
+  EXPECT_EQ(result, expected);
+  EXPECT_EQ(path.Normalize("/" + doubles), "/");
+  EXPECT_EQ(path.Normalize("a/" + doubles), path.Normalize(doubles.substr(3)));
+
+  std::string nested;
+  for (int i = 0; i < kCount; i++) nested += "a/";
+  EXPECT_EQ(path.Normalize(nested + doubles), ".");
+  EXPECT_EQ(path.Normalize(nested + doubles + "b"), "b");
+  EXPECT_EQ(path.Split(nested + doubles).size(),
+      static_cast<size_t>(2 * kCount));
+
+  std::string separators(1 << 20, '/');
+  std::string input = "a" + separators + "b";
+  EXPECT_ALLOCATIONS(1, result = path.Normalize(input));
+  EXPECT_EQ(result, "a/b");
+  EXPECT_EQ(path.Normalize(separators), "/");
+  EXPECT_EQ(path.Dirname("a" + separators + "b" + separators), "a");
+  EXPECT_EQ(path.Dirname(separators + "a" + separators), "/");
+  EXPECT_EQ(path.Dirname(separators), "/");
+  EXPECT_EQ(path.Split(separators + "a" + separators).size(), 2u);
+}
+
 void PosixTests() {
   PosixRootPrefixTests();
   PosixIsAbsoluteTests();
   PosixDirnameTests();
   PosixNormalizeTests();
+  PosixIsNormalizedTests();
   PosixJoinTests();
+  PosixCommonAncestorTests();
+  PosixConvertToTests();
+  PosixIsWithinTests();
+  AllocationTests(Path::kPosix, "/usr/lib/dart/sdk",
+                  "/usr/lib/../lib/./dart//sdk/", 8, "lib");
+  PosixLongPathTests();
 }
 
 void WindowsRootPrefixTests() {
@@ -401,6 +610,116 @@ void WindowsJoinTests() {
   EXPECT_EQ(path.Join("a", "b\\"), "a\\b\\");
 }
 
+void WindowsCommonAncestorTests() {
+  const Path& path = Path::kWindows;
+  std::vector<std::string> paths;
+  paths.push_back("C:\\a\\b");
+  paths.push_back("C:/a/c");
+  EXPECT_EQ(path.CommonAncestor(paths), "C:\\a");
+  paths.push_back("C:\\b");
+  EXPECT_EQ(path.CommonAncestor(paths), "C:\\");
+  paths.push_back("D:\\a");
+  EXPECT_EQ(path.CommonAncestor(paths), "");
+
+  paths.clear();
+  paths.push_back("\\\\server\\share\\a\\b");
+  paths.push_back("\\\\server\\share\\a\\c");
+  EXPECT_EQ(path.CommonAncestor(paths), "\\\\server\\share\\a");
+  paths.push_back("\\\\server\\other\\a");
+  EXPECT_EQ(path.CommonAncestor(paths), "");
+}
+
+void WindowsConvertToTests() {
+  const Path& path = Path::kWindows;
+  EXPECT_EQ(path.ConvertTo(Path::kPosix, "a\\b/c\\"), "a/b/c/");
+  EXPECT_EQ(path.ConvertTo(Path::kPosix, "C:\\a\\b"), "/C:/a/b");
+  EXPECT_EQ(path.ConvertTo(Path::kPosix, "C:/"), "/C:/");
+  EXPECT_EQ(path.ConvertTo(Path::kPosix, "\\a"), "/a");
+  EXPECT_EQ(path.ConvertTo(Path::kPosix, "\\\\server\\share\\a"),
+      "//server/share/a");
+  EXPECT_EQ(path.ConvertTo(Path::kUrl, "a\\b"), "a/b");
+  EXPECT_EQ(path.ConvertTo(Path::kUrl, "C:\\a\\b"), "file:///C:/a/b");
+  EXPECT_EQ(path.ConvertTo(Path::kUrl, "\\a\\b"), "/a/b");
+  EXPECT_EQ(path.ConvertTo(Path::kUrl, "\\\\server\\share\\a"),
+      "file://server/share/a");
+  EXPECT_EQ(path.ConvertTo(Path::kUrl, "\\\\server"), "file://server/");
+
+  // round trips through the other styles
+  const char* paths[] = {
+    "a\\b", "C:\\a\\b", "\\a\\b", "\\\\server\\share\\a\\b"
+  };
+  for (size_t i = 0; i < ARRAY_SIZE(paths); i++) {
+    EXPECT_EQ(Path::kUrl.ConvertTo(path,
+                                   path.ConvertTo(Path::kUrl, paths[i])),
+        paths[i]);
+    EXPECT_EQ(Path::kPosix.ConvertTo(path,
+                                     path.ConvertTo(Path::kPosix, paths[i])),
+        paths[i]);
+  }
+}
+
+void WindowsIsWithinTests() {
+  const Path& path = Path::kWindows;
+  EXPECT(path.IsWithin("C:\\root", "a\\b"));
+  EXPECT(path.IsWithin("C:\\root", "a/b\\..\\c"));
+  EXPECT(path.IsWithin("C:\\root", "C:\\root\\a"));
+  EXPECT(path.IsWithin("C:\\root", "c:/ROOT/a"));
+  EXPECT(path.IsWithin("\\\\server\\share", "\\\\SERVER\\share\\a"));
+
+  EXPECT(!path.IsWithin("C:\\root", "a\\..\\..\\b"));
+  EXPECT(!path.IsWithin("C:\\root", "D:\\root\\a"));
+  EXPECT(!path.IsWithin("C:\\root", "\\root\\a"));
+  EXPECT(!path.IsWithin("C:\\root", "C:\\root"));
+  EXPECT(!path.IsWithin("\\\\server\\share", "\\\\server\\other\\a"));
+}
+
+void WindowsLongPathTests() {
+  const Path& path = Path::kWindows;
+  std::string separators;
+  for (int i = 0; i < (1 << 19); i++) separators += "/\\";
+  std::string input = "C:" + separators + "a" + separators;
+  std::string result;
+  EXPECT_ALLOCATIONS(1, result = path.Normalize(input));
+  EXPECT_EQ(result, "C:\\a");
+  EXPECT_EQ(path.Dirname("a" + separators + "b"), "a");
+
+  std::string doubles;
+  for (int i = 0; i < 100000; i++) doubles += "..\\";
+  EXPECT_EQ(path.Normalize("C:\\a\\" + doubles + "b"), "C:\\b");
+}
+
+void WindowsUtf16Tests() {
+  const Path& path = Path::kWindows;
+  EXPECT(path.IsAbsolute(std::u16string(u"C:\\Benutzer")));
+  EXPECT(!path.IsAbsolute(std::u16string(u"Benutzer")));
+  EXPECT(path.RootPrefix(std::u16string(u"\\\\server\\share\\a")) ==
+         u"\\\\server\\share");
+  EXPECT(path.Dirname(std::u16string(u"C:\\\u00fcber\\\u6587")) ==
+         u"C:\\\u00fcber");
+  EXPECT(path.Normalize(std::u16string(u"C:/\u00fcber/./x/..\\\U0001f600")) ==
+         u"C:\\\u00fcber\\\U0001f600");
+  EXPECT(path.IsNormalized(std::u16string(u"C:\\\u00fcber")));
+  EXPECT(!path.IsNormalized(std::u16string(u"C:/\u00fcber")));
+  EXPECT(path.Join(std::u16string(u"C:\\a"), std::u16string(u"\u00e9")) ==
+         u"C:\\a\\\u00e9");
+
+  std::vector<std::u16string> parts;
+  parts.push_back(u"C:\\");
+  parts.push_back(u"\u00e9");
+  parts.push_back(u"b");
+  EXPECT(path.JoinAll(parts) == u"C:\\\u00e9\\b");
+  std::vector<std::u16string> split = path.Split(path.JoinAll(parts));
+  EXPECT_EQ(split.size(), 3u);
+  EXPECT(split[0] == u"C:\\");
+  EXPECT(split[1] == u"\u00e9");
+
+  // Unpaired surrogates in file names are kept.
+  std::u16string lone = u"C:\\a\\x";
+  lone[5] = 0xd800;
+  EXPECT(path.Dirname(lone + u"\\b") == lone);
+  EXPECT(path.Normalize(lone + u"\\.\\") == lone);
+}
+
 void WindowsTests() {
   WindowsRootPrefixTests();
   WindowsIsAbsoluteTests();
@@ -408,6 +727,13 @@ void WindowsTests() {
   WindowsDirnameTests();
   WindowsNormalizeTests();
   WindowsJoinTests();
+  WindowsCommonAncestorTests();
+  WindowsConvertToTests();
+  WindowsIsWithinTests();
+  WindowsUtf16Tests();
+  AllocationTests(Path::kWindows, "C:\\Users\\dart\\sdk",
+                  "C:/Users\\..\\Users\\.\\dart\\\\sdk\\", 7, "lib");
+  WindowsLongPathTests();
 }
 
 void UrlRootPrefixTests() {
@@ -658,6 +984,56 @@ void UrlJoinTests() {
   EXPECT_EQ(path.Join("a", "b/"), "a/b/");
 }
 
+void UrlCommonAncestorTests() {
+  const Path& path = Path::kUrl;
+  std::vector<std::string> paths;
+  paths.push_back("http://dartlang.org/a/b");
+  paths.push_back("http://dartlang.org/a/c");
+  EXPECT_EQ(path.CommonAncestor(paths), "http://dartlang.org/a");
+  paths.push_back("http://dartlang.org/b");
+  EXPECT_EQ(path.CommonAncestor(paths), "http://dartlang.org");
+  paths.push_back("http://dartlang.org.evil/a");
+  EXPECT_EQ(path.CommonAncestor(paths), "");
+
+  paths.clear();
+  paths.push_back("file:///a/b");
+  paths.push_back("file:///a/b/c");
+  EXPECT_EQ(path.CommonAncestor(paths), "file:///a/b");
+}
+
+void UrlConvertToTests() {
+  const Path& path = Path::kUrl;
+  EXPECT_EQ(path.ConvertTo(Path::kPosix, "a/b%20c"), "a/b%20c");
+  EXPECT_EQ(path.ConvertTo(Path::kPosix, "file:///a/b"), "/a/b");
+  EXPECT_EQ(path.ConvertTo(Path::kPosix, "file://"), "/");
+  EXPECT_EQ(path.ConvertTo(Path::kPosix, "/a/b"), "/a/b");
+  EXPECT_EQ(path.ConvertTo(Path::kWindows, "file:///C:/a/b"), "C:\\a\\b");
+  EXPECT_EQ(path.ConvertTo(Path::kWindows, "file:///a/b"), "\\a\\b");
+  EXPECT_EQ(path.ConvertTo(Path::kWindows, "file://server/share/a"),
+      "\\\\server\\share\\a");
+  EXPECT_EQ(path.ConvertTo(Path::kWindows, "a/b/"), "a\\b\\");
+
+  // has no file path equivalent for other schemes
+  std::string result;
+  const char* url = "http://dartlang.org/a";
+  EXPECT(!path.ConvertTo(Path::kPosix, url, strlen(url), &result));
+  EXPECT_EQ(path.ConvertTo(Path::kWindows, url), "");
+  EXPECT_EQ(path.ConvertTo(Path::kWindows, "package:a/b"), "");
+  EXPECT_EQ(path.ConvertTo(Path::kUrl, url), url);
+}
+
+void UrlIsWithinTests() {
+  const Path& path = Path::kUrl;
+  EXPECT(path.IsWithin("http://dartlang.org/a", "b"));
+  EXPECT(path.IsWithin("http://dartlang.org/a", "http://dartlang.org/a/b"));
+  EXPECT(path.IsWithin("file:///a", "file:///a/b/../c"));
+
+  EXPECT(!path.IsWithin("http://dartlang.org/a", "../b"));
+  EXPECT(!path.IsWithin("http://dartlang.org/a", "http://dartlang.org/b"));
+  EXPECT(!path.IsWithin("http://dartlang.org/a", "http://evil.org/a/b"));
+  EXPECT(!path.IsWithin("http://dartlang.org/a", "/a/b"));
+}
+
 void UrlTests() {
   UrlRootPrefixTests();
   UrlIsAbsoluteTests();
@@ -665,6 +1041,11 @@ void UrlTests() {
   UrlDirnameTests();
   UrlNormalizeTests();
   UrlJoinTests();
+  UrlCommonAncestorTests();
+  UrlConvertToTests();
+  UrlIsWithinTests();
+  AllocationTests(Path::kUrl, "http://dartlang.org/a/b/c",
+                  "http://dartlang.org/a/../a/./b//c/", 7, "lib");
 }
 
 extern void ExecutePathTests() {
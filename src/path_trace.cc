@@ -0,0 +1,267 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/path_trace.h"
+
+#include "native/platform/assert.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <mutex>
+
+namespace dart {
+namespace snapshotter {
+
+static const char kMagic[4] = { 'P', 'T', 'R', 'C' };
+static const uint8_t kVersion = 1;
+
+static const char* const kOperationNames[kNumPathOperations] = {
+  "IsAbsolute",
+  "RootPrefix",
+  "Dirname",
+  "Normalize",
+  "IsNormalized",
+  "JoinAll",
+  "Split",
+  "CommonAncestor",
+  "IsWithin",
+  "ConvertTo",
+};
+
+const char* PathOperationName(PathOperation operation) {
+  ASSERT(operation >= 0 && operation < kNumPathOperations);
+  return kOperationNames[operation];
+}
+
+#if defined(PATH_TRACE)
+
+// A thread writes out its buffered records once they reach this size.
+static const size_t kFlushSize = 256 * 1024;
+
+static void AppendVarint(std::string* out, uint64_t value) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+std::atomic<bool> PathRecorder::recording_(false);
+
+// Locks are taken in the order registry_mutex, ThreadBuffer::mutex,
+// file_mutex.
+static std::mutex file_mutex;
+static FILE* trace_file = NULL;
+static bool trace_failed = false;
+
+// Appends |buffer| to the trace and clears it.
+static void Write(std::string* buffer) {
+  std::lock_guard<std::mutex> lock(file_mutex);
+  if (trace_file != NULL && !buffer->empty() &&
+      fwrite(buffer->data(), 1, buffer->length(), trace_file) !=
+          buffer->length()) {
+    trace_failed = true;
+  }
+  buffer->clear();
+}
+
+// The records of one thread that have not been written yet. Its lock is
+// only contended while Stop collects it.
+struct ThreadBuffer;
+static std::mutex registry_mutex;
+static std::vector<ThreadBuffer*> thread_buffers;
+
+struct ThreadBuffer {
+  ThreadBuffer() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    thread_buffers.push_back(this);
+  }
+  ~ThreadBuffer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      Write(&records);
+    }
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    thread_buffers.erase(
+        std::find(thread_buffers.begin(), thread_buffers.end(), this));
+  }
+
+  std::mutex mutex;
+  std::string records;
+};
+
+static thread_local ThreadBuffer thread_buffer;
+// Set while this thread is inside a recorded call.
+static thread_local bool in_recorded_call = false;
+
+bool PathRecorder::Start(const char* filename) {
+  std::lock_guard<std::mutex> lock(file_mutex);
+  if (trace_file != NULL) return false;
+  trace_file = fopen(filename, "wb");
+  if (trace_file == NULL) return false;
+  trace_failed = false;
+  std::string header(kMagic, sizeof(kMagic));
+  header.push_back(static_cast<char>(kVersion));
+  if (fwrite(header.data(), 1, header.length(), trace_file) !=
+      header.length()) {
+    trace_failed = true;
+  }
+  recording_.store(true, std::memory_order_relaxed);
+  return true;
+}
+
+bool PathRecorder::Stop() {
+  std::lock_guard<std::mutex> registry_lock(registry_mutex);
+  {
+    std::lock_guard<std::mutex> lock(file_mutex);
+    if (trace_file == NULL) return false;
+    recording_.store(false, std::memory_order_relaxed);
+  }
+  for (size_t i = 0; i < thread_buffers.size(); i++) {
+    ThreadBuffer* buffer = thread_buffers[i];
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    Write(&buffer->records);
+    std::string().swap(buffer->records);
+  }
+  std::lock_guard<std::mutex> lock(file_mutex);
+  if (fclose(trace_file) != 0) trace_failed = true;
+  trace_file = NULL;
+  return !trace_failed;
+}
+
+bool PathRecorder::Enter(PathOperation operation,
+                         const Path& path,
+                         const Path* target,
+                         const char* const* data,
+                         const size_t* lengths,
+                         size_t count) {
+  if (in_recorded_call) return false;
+  in_recorded_call = true;
+
+  ThreadBuffer& buffer = thread_buffer;
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  // Stop may have run since the caller checked IsRecording.
+  if (!IsRecording()) return true;
+  std::string* records = &buffer.records;
+  records->push_back(static_cast<char>(operation));
+  uint32_t styles = path.id();
+  if (target != NULL) styles |= (target->id() + 1) << 4;
+  records->push_back(static_cast<char>(styles));
+  AppendVarint(records, count);
+  for (size_t i = 0; i < count; i++) {
+    AppendVarint(records, lengths[i]);
+    records->append(data[i], lengths[i]);
+  }
+  if (records->length() >= kFlushSize) Write(records);
+  return true;
+}
+
+void PathRecorder::Exit() {
+  in_recorded_call = false;
+}
+
+void PathTraceScope::Enter(PathOperation operation,
+                           const Path& path,
+                           const std::string* arguments,
+                           size_t count) {
+  std::vector<const char*> data(count);
+  std::vector<size_t> lengths(count);
+  for (size_t i = 0; i < count; i++) {
+    data[i] = arguments[i].data();
+    lengths[i] = arguments[i].length();
+  }
+  entered_ = PathRecorder::Enter(operation, path, NULL,
+                                 count > 0 ? &data[0] : NULL,
+                                 count > 0 ? &lengths[0] : NULL, count);
+}
+
+#else  // defined(PATH_TRACE)
+
+bool PathRecorder::Start(const char* filename) {
+  return false;
+}
+
+bool PathRecorder::Stop() {
+  return false;
+}
+
+#endif  // defined(PATH_TRACE)
+
+PathTraceReader::PathTraceReader() : position_(0), error_(false) {}
+
+bool PathTraceReader::Open(const char* filename) {
+  FILE* file = fopen(filename, "rb");
+  if (file == NULL) return false;
+  std::string data;
+  char buffer[1 << 16];
+  size_t read;
+  while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    data.append(buffer, read);
+  }
+  bool ok = ferror(file) == 0;
+  fclose(file);
+  return ok && Init(data.data(), data.length());
+}
+
+bool PathTraceReader::Init(const void* data, size_t length) {
+  data_.assign(static_cast<const char*>(data), length);
+  position_ = 0;
+  error_ = false;
+  if (length < sizeof(kMagic) + 1 ||
+      memcmp(data, kMagic, sizeof(kMagic)) != 0 ||
+      static_cast<uint8_t>(data_[sizeof(kMagic)]) != kVersion) {
+    error_ = true;
+    return false;
+  }
+  position_ = sizeof(kMagic) + 1;
+  return true;
+}
+
+bool PathTraceReader::ReadVarint(uint64_t* value) {
+  *value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (position_ >= data_.length()) return false;
+    uint8_t byte = static_cast<uint8_t>(data_[position_++]);
+    *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) return true;
+  }
+  return false;
+}
+
+bool PathTraceReader::Next(PathTraceRecord* record) {
+  if (error_ || position_ == data_.length()) return false;
+  error_ = true;
+  if (data_.length() - position_ < 2) return false;
+  uint8_t operation = static_cast<uint8_t>(data_[position_++]);
+  uint8_t styles = static_cast<uint8_t>(data_[position_++]);
+  if (operation >= kNumPathOperations) return false;
+  record->operation = static_cast<PathOperation>(operation);
+  record->path = Path::FromId(styles & 0xf);
+  record->target = NULL;
+  if (record->path == NULL) return false;
+  if ((styles >> 4) != 0) {
+    record->target = Path::FromId((styles >> 4) - 1);
+    if (record->target == NULL) return false;
+  }
+  uint64_t count;
+  if (!ReadVarint(&count) || count > data_.length() - position_) {
+    return false;
+  }
+  record->arguments.resize(count);
+  for (uint64_t i = 0; i < count; i++) {
+    uint64_t length;
+    if (!ReadVarint(&length) || length > data_.length() - position_) {
+      return false;
+    }
+    record->arguments[i].assign(data_, position_, length);
+    position_ += length;
+  }
+  error_ = false;
+  return true;
+}
+
+}  // namespace snapshotter
+}  // namespace dart
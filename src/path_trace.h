@@ -0,0 +1,221 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_PATH_TRACE_H_
+#define SRC_NATIVE_SNAPSHOTTER_PATH_TRACE_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "native/platform/globals.h"
+#include "native/snapshotter/path.h"
+
+// Captures the Path calls a process makes, so that a real workload can be
+// replayed against the library later (see path_replay.h).
+//
+// A trace is a header followed by one record per call:
+//
+//   header:  "PTRC" u8(version)
+//   record:  u8(operation) u8(style | (target + 1) << 4)
+//            varint(count) { varint(length) bytes }*
+//
+// where styles are numbered by Path::id(), and a target is only present
+// for ConvertTo. Calls made by Path functions to each other are not
+// recorded, so replaying a trace repeats exactly the calls of the process.
+// Each thread buffers its own records, so the records of one thread are in
+// order but those of different threads are interleaved in blocks.
+//
+// Recording is only compiled in when PATH_TRACE is defined. Otherwise the
+// hooks in Path are empty and PathRecorder::Start fails; traces can still
+// be read and replayed.
+
+namespace dart {
+namespace snapshotter {
+
+enum PathOperation {
+  kPathIsAbsolute,
+  kPathRootPrefix,
+  kPathDirname,
+  kPathNormalize,
+  kPathIsNormalized,
+  kPathJoinAll,
+  kPathSplit,
+  kPathCommonAncestor,
+  kPathIsWithin,
+  kPathConvertTo,
+  kNumPathOperations
+};
+
+const char* PathOperationName(PathOperation operation);
+
+class PathRecorder {
+ public:
+  // Starts recording the Path calls of every thread to |filename|. Returns
+  // false if a recording is already running, the file cannot be created,
+  // or recording is not compiled in.
+  static bool Start(const char* filename);
+
+  // Stops recording, and writes out what every thread has buffered.
+  // Returns false if no recording was running or writing failed at any
+  // point.
+  static bool Stop();
+
+  static bool IsRecording() {
+#if defined(PATH_TRACE)
+    return recording_.load(std::memory_order_relaxed);
+#else
+    return false;
+#endif
+  }
+
+ private:
+  friend class PathTraceScope;
+
+#if defined(PATH_TRACE)
+  // Records a call unless this thread is already inside a recorded call,
+  // and returns whether it did.
+  static bool Enter(PathOperation operation,
+                    const Path& path,
+                    const Path* target,
+                    const char* const* data,
+                    const size_t* lengths,
+                    size_t count);
+  static void Exit();
+
+  static std::atomic<bool> recording_;
+#endif
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(PathRecorder);
+};
+
+#if defined(PATH_TRACE)
+// Records the Path call it is declared in, if a recording is running. Costs
+// one relaxed load otherwise.
+class PathTraceScope {
+ public:
+  PathTraceScope(PathOperation operation,
+                 const Path& path,
+                 const char* data,
+                 size_t length,
+                 const Path* target = NULL)
+      : entered_(false) {
+    if (PathRecorder::IsRecording()) {
+      entered_ = PathRecorder::Enter(operation, path, target, &data, &length,
+                                     1);
+    }
+  }
+  PathTraceScope(PathOperation operation,
+                 const Path& path,
+                 const std::string& argument)
+      : entered_(false) {
+    if (PathRecorder::IsRecording()) {
+      const char* data = argument.data();
+      size_t length = argument.length();
+      entered_ = PathRecorder::Enter(operation, path, NULL, &data, &length,
+                                     1);
+    }
+  }
+  PathTraceScope(PathOperation operation,
+                 const Path& path,
+                 const std::string& first,
+                 const std::string& second)
+      : entered_(false) {
+    if (PathRecorder::IsRecording()) {
+      const char* data[2] = { first.data(), second.data() };
+      size_t lengths[2] = { first.length(), second.length() };
+      entered_ = PathRecorder::Enter(operation, path, NULL, data, lengths, 2);
+    }
+  }
+  PathTraceScope(PathOperation operation,
+                 const Path& path,
+                 const std::string* arguments,
+                 size_t count)
+      : entered_(false) {
+    if (PathRecorder::IsRecording()) Enter(operation, path, arguments, count);
+  }
+
+  ~PathTraceScope() {
+    if (entered_) PathRecorder::Exit();
+  }
+
+ private:
+  void Enter(PathOperation operation,
+             const Path& path,
+             const std::string* arguments,
+             size_t count);
+
+  bool entered_;
+
+  DISALLOW_COPY_AND_ASSIGN(PathTraceScope);
+};
+#else
+// Compiles away when recording is not compiled in.
+class PathTraceScope {
+ public:
+  PathTraceScope(PathOperation operation,
+                 const Path& path,
+                 const char* data,
+                 size_t length,
+                 const Path* target = NULL) {}
+  PathTraceScope(PathOperation operation,
+                 const Path& path,
+                 const std::string& argument) {}
+  PathTraceScope(PathOperation operation,
+                 const Path& path,
+                 const std::string& first,
+                 const std::string& second) {}
+  PathTraceScope(PathOperation operation,
+                 const Path& path,
+                 const std::string* arguments,
+                 size_t count) {}
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(PathTraceScope);
+};
+#endif  // defined(PATH_TRACE)
+
+// One recorded call.
+struct PathTraceRecord {
+  PathOperation operation;
+  const Path* path;
+  // The target of ConvertTo, or NULL.
+  const Path* target;
+  std::vector<std::string> arguments;
+};
+
+// Reads the records of a trace.
+class PathTraceReader {
+ public:
+  PathTraceReader();
+
+  // Reads the trace in |filename|. Returns false if it cannot be read or
+  // does not start with a valid header.
+  bool Open(const char* filename);
+
+  // Uses the trace in |data|, which is copied.
+  bool Init(const void* data, size_t length);
+
+  // Reads the next record into |record|. Returns false at the end of the
+  // trace, or at a malformed record; error() tells the two apart.
+  bool Next(PathTraceRecord* record);
+
+  bool error() const { return error_; }
+
+ private:
+  bool ReadVarint(uint64_t* value);
+
+  std::string data_;
+  size_t position_;
+  bool error_;
+
+  DISALLOW_COPY_AND_ASSIGN(PathTraceReader);
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_PATH_TRACE_H_
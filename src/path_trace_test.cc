@@ -0,0 +1,161 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path.h"
+#include "native/snapshotter/path_trace.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+namespace dart {
+namespace snapshotter {
+
+#if defined(PATH_TRACE)
+void PathTraceRecordTests() {
+  char filename[] = "/tmp/path_trace_test_XXXXXX";
+  int fd = mkstemp(filename);
+  EXPECT(fd >= 0);
+  close(fd);
+
+  EXPECT(!PathRecorder::IsRecording());
+  EXPECT(PathRecorder::Start(filename));
+  EXPECT(PathRecorder::IsRecording());
+  EXPECT(!PathRecorder::Start(filename));
+  Path::kPosix.Normalize("a/./b");
+  Path::kWindows.Join("C:\\a", "b");
+  Path::kPosix.IsWithin("/a", "b");
+  Path::kWindows.ConvertTo(Path::kUrl, "C:\\a");
+  std::string binary("a\0b", 3);
+  Path::kUrl.Split(binary);
+  EXPECT(PathRecorder::Stop());
+  EXPECT(!PathRecorder::IsRecording());
+  EXPECT(!PathRecorder::Stop());
+  // Not recorded.
+  Path::kPosix.Dirname("/a/b");
+
+  PathTraceReader reader;
+  EXPECT(reader.Open(filename));
+  unlink(filename);
+  PathTraceRecord record;
+
+  // Normalize does not record the IsNormalized call it makes.
+  EXPECT(reader.Next(&record));
+  EXPECT_EQ(record.operation, kPathNormalize);
+  EXPECT_EQ(record.path, &Path::kPosix);
+  EXPECT(record.target == NULL);
+  EXPECT_EQ(record.arguments.size(), 1u);
+  EXPECT_EQ(record.arguments[0], "a/./b");
+
+  // Join is recorded as the JoinAll it calls.
+  EXPECT(reader.Next(&record));
+  EXPECT_EQ(record.operation, kPathJoinAll);
+  EXPECT_EQ(record.path, &Path::kWindows);
+  EXPECT(record.arguments.size() >= 2u);
+  EXPECT_EQ(record.arguments[0], "C:\\a");
+  EXPECT_EQ(record.arguments[1], "b");
+
+  EXPECT(reader.Next(&record));
+  EXPECT_EQ(record.operation, kPathIsWithin);
+  EXPECT_EQ(record.arguments.size(), 2u);
+  EXPECT_EQ(record.arguments[1], "b");
+
+  EXPECT(reader.Next(&record));
+  EXPECT_EQ(record.operation, kPathConvertTo);
+  EXPECT_EQ(record.path, &Path::kWindows);
+  EXPECT_EQ(record.target, &Path::kUrl);
+
+  EXPECT(reader.Next(&record));
+  EXPECT_EQ(record.operation, kPathSplit);
+  EXPECT_EQ(record.path, &Path::kUrl);
+  EXPECT_EQ(record.arguments[0], binary);
+
+  EXPECT(!reader.Next(&record));
+  EXPECT(!reader.error());
+}
+
+void PathTraceThreadTests() {
+  char filename[] = "/tmp/path_trace_test_XXXXXX";
+  int fd = mkstemp(filename);
+  EXPECT(fd >= 0);
+  close(fd);
+
+  const int kThreads = 4;
+  const int kCalls = 1000;
+  EXPECT(PathRecorder::Start(filename));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; i++) {
+    threads.push_back(std::thread([]() {
+      for (int j = 0; j < kCalls; j++) Path::kPosix.Dirname("/a/b");
+    }));
+  }
+  // Some threads are still running, so Stop collects their buffers.
+  threads[0].join();
+  EXPECT(PathRecorder::Stop());
+  for (int i = 1; i < kThreads; i++) threads[i].join();
+
+  PathTraceReader reader;
+  EXPECT(reader.Open(filename));
+  unlink(filename);
+  PathTraceRecord record;
+  int count = 0;
+  while (reader.Next(&record)) {
+    EXPECT_EQ(record.operation, kPathDirname);
+    EXPECT_EQ(record.arguments[0], "/a/b");
+    count++;
+  }
+  EXPECT(!reader.error());
+  EXPECT(count >= kCalls);
+  EXPECT(count <= kThreads * kCalls);
+}
+#else
+void PathTraceDisabledTests() {
+  EXPECT(!PathRecorder::Start("/tmp/path_trace_test_disabled"));
+  EXPECT(!PathRecorder::IsRecording());
+  EXPECT(!PathRecorder::Stop());
+}
+#endif  // defined(PATH_TRACE)
+
+void PathTraceReaderTests() {
+  PathTraceReader reader;
+  PathTraceRecord record;
+  EXPECT(!reader.Init("PTRX\x01", 5));
+  EXPECT(!reader.Init("PTRC\x02", 5));
+  EXPECT(reader.Init("PTRC\x01", 5));
+  EXPECT(!reader.Next(&record));
+  EXPECT(!reader.error());
+
+  // Normalize, Posix, one argument "ab".
+  EXPECT(reader.Init("PTRC\x01\x03\x00\x01\x02" "ab", 11));
+  EXPECT(reader.Next(&record));
+  EXPECT_EQ(record.arguments[0], "ab");
+
+  // Truncated argument.
+  EXPECT(reader.Init("PTRC\x01\x03\x00\x01\x03" "ab", 11));
+  EXPECT(!reader.Next(&record));
+  EXPECT(reader.error());
+  // Unknown operation and style.
+  EXPECT(reader.Init("PTRC\x01\x7f\x00\x00", 8));
+  EXPECT(!reader.Next(&record));
+  EXPECT(reader.Init("PTRC\x01\x03\x09\x00", 8));
+  EXPECT(!reader.Next(&record));
+  EXPECT(reader.error());
+}
+
+extern void ExecutePathTraceTests() {
+#if defined(PATH_TRACE)
+  PathTraceRecordTests();
+  PathTraceThreadTests();
+#else
+  PathTraceDisabledTests();
+#endif
+  PathTraceReaderTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
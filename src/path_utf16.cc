@@ -0,0 +1,134 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/path_utf16.h"
+
+#include "native/snapshotter/path_simd.h"
+
+#include <stdint.h>
+
+namespace dart {
+namespace snapshotter {
+
+static const char16_t kReplacement = 0xfffd;
+
+static bool IsHighSurrogate(uint32_t unit) {
+  return unit >= 0xd800 && unit <= 0xdbff;
+}
+
+static bool IsLowSurrogate(uint32_t unit) {
+  return unit >= 0xdc00 && unit <= 0xdfff;
+}
+
+static bool IsContinuation(uint8_t byte) {
+  return (byte & 0xc0) == 0x80;
+}
+
+size_t PathUtf16::ToUtf8(const char16_t* data, size_t length, char* out) {
+  size_t i = 0;
+  char* start = out;
+  while (i < length) {
+    size_t ascii = PathSimd::NarrowAscii(data + i, length - i, out);
+    i += ascii;
+    out += ascii;
+    if (i == length) break;
+
+    uint32_t code = data[i++];
+    if (code < 0x80) {
+      *out++ = static_cast<char>(code);
+    } else if (code < 0x800) {
+      *out++ = static_cast<char>(0xc0 | (code >> 6));
+      *out++ = static_cast<char>(0x80 | (code & 0x3f));
+    } else if (IsHighSurrogate(code) && i < length &&
+               IsLowSurrogate(data[i])) {
+      code = 0x10000 + ((code - 0xd800) << 10) + (data[i++] - 0xdc00);
+      *out++ = static_cast<char>(0xf0 | (code >> 18));
+      *out++ = static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+      *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+      *out++ = static_cast<char>(0x80 | (code & 0x3f));
+    } else {
+      // Includes unpaired surrogates.
+      *out++ = static_cast<char>(0xe0 | (code >> 12));
+      *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+      *out++ = static_cast<char>(0x80 | (code & 0x3f));
+    }
+  }
+  return out - start;
+}
+
+// Decodes the sequence at the start of |data|, which begins with a byte of
+// 0x80 or above. Returns the number of bytes it takes, or zero if it is
+// malformed.
+static size_t DecodeSequence(const uint8_t* data,
+                             size_t length,
+                             uint32_t* code) {
+  uint8_t lead = data[0];
+  size_t size;
+  uint32_t min;
+  if (lead >= 0xc2 && lead <= 0xdf) {
+    size = 2;
+    min = 0x80;
+    *code = lead & 0x1f;
+  } else if (lead >= 0xe0 && lead <= 0xef) {
+    size = 3;
+    min = 0x800;
+    *code = lead & 0x0f;
+  } else if (lead >= 0xf0 && lead <= 0xf4) {
+    size = 4;
+    min = 0x10000;
+    *code = lead & 0x07;
+  } else {
+    return 0;
+  }
+  if (size > length) return 0;
+  for (size_t i = 1; i < size; i++) {
+    if (!IsContinuation(data[i])) return 0;
+    *code = (*code << 6) | (data[i] & 0x3f);
+  }
+  // Surrogates are accepted, as ToUtf8 writes unpaired ones this way.
+  if (*code < min || *code > 0x10ffff) return 0;
+  return size;
+}
+
+size_t PathUtf16::ToUtf16(const char* data,
+                          size_t length,
+                          char16_t* out,
+                          bool* valid) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  size_t i = 0;
+  char16_t* start = out;
+  bool malformed = false;
+  while (i < length) {
+    size_t ascii = PathSimd::WidenAscii(data + i, length - i, out);
+    i += ascii;
+    out += ascii;
+    if (i == length) break;
+
+    if (bytes[i] < 0x80) {
+      *out++ = bytes[i++];
+      continue;
+    }
+    uint32_t code;
+    size_t size = DecodeSequence(bytes + i, length - i, &code);
+    if (size == 0) {
+      malformed = true;
+      *out++ = kReplacement;
+      i++;
+    } else if (code >= 0x10000) {
+      // Four bytes become two units, so |out| keeps up with |i|.
+      code -= 0x10000;
+      *out++ = static_cast<char16_t>(0xd800 + (code >> 10));
+      *out++ = static_cast<char16_t>(0xdc00 + (code & 0x3ff));
+      i += size;
+    } else {
+      *out++ = static_cast<char16_t>(code);
+      i += size;
+    }
+  }
+  if (valid != NULL) *valid = !malformed;
+  return out - start;
+}
+
+}  // namespace snapshotter
+}  // namespace dart
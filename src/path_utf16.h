@@ -0,0 +1,68 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_PATH_UTF16_H_
+#define SRC_NATIVE_SNAPSHOTTER_PATH_UTF16_H_
+
+#include <string>
+
+#include "native/platform/globals.h"
+
+namespace dart {
+namespace snapshotter {
+
+// Transcodes paths between UTF-16, as used by Windows, and the UTF-8 the
+// Path functions work on. Runs of ASCII are converted 16 characters at a
+// time with SIMD.
+//
+// Windows file names may contain unpaired surrogates, so they are encoded
+// as the three byte sequences UTF-8 would use for them if they were code
+// points (WTF-8), and decoded back unchanged. Path functions only cut and
+// join paths at ASCII separators, so a round trip through them is
+// lossless.
+class PathUtf16 {
+ public:
+  // Converts the |length| units of |data| to UTF-8, storing the result in
+  // |out|, which must have room for 3 * |length| bytes. Returns the number
+  // of bytes written.
+  static size_t ToUtf8(const char16_t* data, size_t length, char* out);
+
+  // Converts the |length| bytes of |data| to UTF-16, storing the result in
+  // |out|, which must have room for |length| units. Returns the number of
+  // units written. Malformed sequences are replaced with U+FFFD, and
+  // |*valid|, if given, is set to whether there were none.
+  static size_t ToUtf16(const char* data,
+                        size_t length,
+                        char16_t* out,
+                        bool* valid = NULL);
+
+  // String versions, for std::u16string and, where wchar_t is 16 bits as on
+  // Windows, std::wstring.
+  template <typename Char>
+  static std::string ToUtf8(const std::basic_string<Char>& path) {
+    static_assert(sizeof(Char) == sizeof(char16_t),
+                  "PathUtf16 needs 16-bit characters");
+    std::string result(3 * path.length(), '\0');
+    result.resize(ToUtf8(reinterpret_cast<const char16_t*>(path.data()),
+                         path.length(), &result[0]));
+    return result;
+  }
+  template <typename Char>
+  static std::basic_string<Char> ToUtf16(const std::string& path) {
+    static_assert(sizeof(Char) == sizeof(char16_t),
+                  "PathUtf16 needs 16-bit characters");
+    std::basic_string<Char> result(path.length(), 0);
+    result.resize(ToUtf16(path.data(), path.length(),
+                          reinterpret_cast<char16_t*>(&result[0])));
+    return result;
+  }
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(PathUtf16);
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_PATH_UTF16_H_
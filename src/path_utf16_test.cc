@@ -0,0 +1,80 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path_utf16.h"
+
+namespace dart {
+namespace snapshotter {
+
+static std::string ToUtf8(const std::u16string& path) {
+  return PathUtf16::ToUtf8(path);
+}
+
+static std::u16string ToUtf16(const std::string& path) {
+  return PathUtf16::ToUtf16<char16_t>(path);
+}
+
+void PathUtf16ConversionTests() {
+  EXPECT_EQ(ToUtf8(u""), "");
+  EXPECT_EQ(ToUtf16(""), u"");
+  EXPECT_EQ(ToUtf8(u"C:\\a\\b.dart"), "C:\\a\\b.dart");
+  EXPECT_EQ(ToUtf16("C:\\a\\b.dart"), u"C:\\a\\b.dart");
+
+  // Two, three and four byte sequences.
+  EXPECT_EQ(ToUtf8(u"\u00e9\u4e2d\U0001f600"),
+            "\xc3\xa9\xe4\xb8\xad\xf0\x9f\x98\x80");
+  EXPECT_EQ(ToUtf16("\xc3\xa9\xe4\xb8\xad\xf0\x9f\x98\x80"),
+            u"\u00e9\u4e2d\U0001f600");
+
+  // Unpaired surrogates survive a round trip.
+  std::u16string lone;
+  lone.push_back(u'a');
+  lone.push_back(0xd800);
+  lone.push_back(u'b');
+  lone.push_back(0xdc00);
+  EXPECT_EQ(ToUtf8(lone), "a\xed\xa0\x80" "b\xed\xb0\x80");
+  EXPECT(ToUtf16(ToUtf8(lone)) == lone);
+
+  // Malformed sequences are replaced.
+  bool valid = true;
+  char16_t out[8];
+  EXPECT_EQ(PathUtf16::ToUtf16("a\xff" "b", 3, out, &valid), 3u);
+  EXPECT(!valid);
+  EXPECT_EQ(out[1], 0xfffd);
+  EXPECT_EQ(ToUtf16("\xc0\xaf"), u"\ufffd\ufffd");
+  EXPECT_EQ(ToUtf16("\xe4\xb8"), u"\ufffd\ufffd");
+  EXPECT_EQ(ToUtf16("\xf4\x90\x80\x80"), u"\ufffd\ufffd\ufffd\ufffd");
+  EXPECT_EQ(PathUtf16::ToUtf16("\xc3\xa9", 2, out, &valid), 1u);
+  EXPECT(valid);
+}
+
+void PathUtf16BlockTests() {
+  // Non-ASCII characters at every offset around the 16 unit blocks.
+  for (size_t position = 0; position < 40; position++) {
+    std::u16string wide(48, u'x');
+    wide[position] = u'\u00fc';
+    std::string narrow = ToUtf8(wide);
+    EXPECT_EQ(narrow.length(), 49u);
+    EXPECT_EQ(narrow.substr(0, position), std::string(position, 'x'));
+    EXPECT_EQ(narrow.substr(position, 2), "\xc3\xbc");
+    EXPECT(ToUtf16(narrow) == wide);
+  }
+
+  std::string ascii;
+  for (int i = 0; i < 1000; i++) ascii.push_back(' ' + i % 95);
+  std::u16string wide = ToUtf16(ascii);
+  EXPECT_EQ(wide.length(), ascii.length());
+  EXPECT_EQ(wide[999], static_cast<char16_t>(ascii[999]));
+  EXPECT_EQ(ToUtf8(wide), ascii);
+}
+
+extern void ExecutePathUtf16Tests() {
+  PathUtf16ConversionTests();
+  PathUtf16BlockTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
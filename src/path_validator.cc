@@ -0,0 +1,82 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/path_validator.h"
+
+#include "native/platform/assert.h"
+#include "native/snapshotter/path_simd.h"
+
+#include <string.h>
+
+namespace dart {
+namespace snapshotter {
+
+static char ToUpper(char c) {
+  return (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c;
+}
+
+static bool EqualsIgnoringCase(const char* data,
+                               size_t length,
+                               const char* upper) {
+  if (length != strlen(upper)) return false;
+  for (size_t i = 0; i < length; i++) {
+    if (ToUpper(data[i]) != upper[i]) return false;
+  }
+  return true;
+}
+
+// Returns true if |name| is a DOS device name. Windows reserves these in
+// every directory, whatever follows the first '.', and ignores spaces
+// before it.
+static bool IsReservedName(const char* name, size_t length) {
+  const char* dot = static_cast<const char*>(memchr(name, '.', length));
+  if (dot != NULL) length = dot - name;
+  while (length > 0 && name[length - 1] == ' ') length--;
+  if (length == 3) {
+    return EqualsIgnoringCase(name, 3, "CON") ||
+        EqualsIgnoringCase(name, 3, "PRN") ||
+        EqualsIgnoringCase(name, 3, "AUX") ||
+        EqualsIgnoringCase(name, 3, "NUL");
+  }
+  // The console input and output buffers.
+  if (length == 6) return EqualsIgnoringCase(name, 6, "CONIN$");
+  if (length == 7) return EqualsIgnoringCase(name, 7, "CONOUT$");
+  if (length < 4 || !(EqualsIgnoringCase(name, 3, "COM") ||
+                      EqualsIgnoringCase(name, 3, "LPT"))) {
+    return false;
+  }
+  // A digit, or a superscript one, two or three in UTF-8.
+  if (length == 4) return name[3] >= '0' && name[3] <= '9';
+  return length == 5 && name[3] == '\xc2' &&
+      (name[4] == '\xb9' || name[4] == '\xb2' || name[4] == '\xb3');
+}
+
+int PathValidator::Check(const Path& path, const char* data, size_t length) {
+  int problems = 0;
+  size_t i = PathSimd::FindControl(data, length);
+  while (i < length) {
+    problems |= data[i] == '\0' ? kNulByte : kControlCharacter;
+    if (problems == (kNulByte | kControlCharacter)) break;
+    i += 1 + PathSimd::FindControl(data + i + 1, length - i - 1);
+  }
+
+  if (!path.style().IsWindows()) return problems;
+  PathComponentIterator it(path.style(), data, length);
+  while (it.Next()) {
+    const char* name = it.component();
+    size_t name_length = it.component_length();
+    char last = name[name_length - 1];
+    if ((last == '.' || last == ' ') &&
+        !(name_length == 1 && name[0] == '.') &&
+        !(name_length == 2 && name[0] == '.' && name[1] == '.')) {
+      problems |= kTrailingDotOrSpace;
+    }
+    if (IsReservedName(name, name_length)) problems |= kReservedName;
+    if (memchr(name, ':', name_length) != NULL) problems |= kColon;
+  }
+  return problems;
+}
+
+}  // namespace snapshotter
+}  // namespace dart
@@ -0,0 +1,58 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_PATH_VALIDATOR_H_
+#define SRC_NATIVE_SNAPSHOTTER_PATH_VALIDATOR_H_
+
+#include <string>
+
+#include "native/platform/globals.h"
+#include "native/snapshotter/path.h"
+
+namespace dart {
+namespace snapshotter {
+
+// Checks paths from untrusted sources, such as package archives, for names
+// that can't safely be created on disk.
+class PathValidator {
+ public:
+  // The problems Check reports, as bits of its result.
+  enum Problem {
+    kNulByte = 1 << 0,
+    // Any other byte below 0x20.
+    kControlCharacter = 1 << 1,
+    // A Windows device name such as "CON", "nul.txt", "COM1" or "CONIN$",
+    // in any case and with any extension. Windows style only.
+    kReservedName = 1 << 2,
+    // A component ending in '.' or ' ', which Windows silently strips.
+    // Windows style only.
+    kTrailingDotOrSpace = 1 << 3,
+    // A ':' after the root, which Windows reads as a drive ("D:evil") or an
+    // alternate data stream ("name:stream"). Windows style only.
+    kColon = 1 << 4,
+  };
+
+  // Returns the problems found in |data|, in the style of |path|, or zero if
+  // there are none. The control character scan handles 16 bytes at a time.
+  static int Check(const Path& path, const char* data, size_t length);
+  static int Check(const Path& path, const std::string& data) {
+    return Check(path, data.data(), data.length());
+  }
+
+  // Returns true if |untrusted| has none of the problems above and stays
+  // strictly within |base| (see Path::IsWithin). Does not allocate.
+  static bool IsSafe(const Path& path,
+                     const std::string& base,
+                     const std::string& untrusted) {
+    return Check(path, untrusted) == 0 && path.IsWithin(base, untrusted);
+  }
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(PathValidator);
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_PATH_VALIDATOR_H_
@@ -0,0 +1,103 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path.h"
+#include "native/snapshotter/path_validator.h"
+
+#include <string>
+
+namespace dart {
+namespace snapshotter {
+
+void PathValidatorControlTests() {
+  const Path& path = Path::kPosix;
+  EXPECT_EQ(PathValidator::Check(path, ""), 0);
+  EXPECT_EQ(PathValidator::Check(path, "lib/src/a.dart"), 0);
+  EXPECT_EQ(PathValidator::Check(path, "caf\xc3\xa9/\x7f"), 0);
+  EXPECT_EQ(PathValidator::Check(path, std::string("a\0b", 3)),
+      PathValidator::kNulByte);
+  EXPECT_EQ(PathValidator::Check(path, "a\nb"),
+      PathValidator::kControlCharacter);
+  EXPECT_EQ(PathValidator::Check(path, std::string("\x1f\0", 2)),
+      PathValidator::kNulByte | PathValidator::kControlCharacter);
+
+  // finds problems on either side of a 16 byte boundary
+  for (size_t i = 0; i < 40; i++) {
+    std::string name(40, 'a');
+    name[i] = '\t';
+    EXPECT_EQ(PathValidator::Check(path, name),
+        PathValidator::kControlCharacter);
+    name[i] = '\0';
+    EXPECT_EQ(PathValidator::Check(path, name), PathValidator::kNulByte);
+  }
+
+  // only checks names for Windows
+  EXPECT_EQ(PathValidator::Check(path, "a/con/b. "), 0);
+  EXPECT_EQ(PathValidator::Check(Path::kUrl, "a/con/b. "), 0);
+}
+
+void PathValidatorWindowsTests() {
+  const Path& path = Path::kWindows;
+  EXPECT_EQ(PathValidator::Check(path, "C:\\a\\b.txt"), 0);
+  EXPECT_EQ(PathValidator::Check(path, "..\\.\\a"), 0);
+  EXPECT_EQ(PathValidator::Check(path, "console\\com10\\lpt\\nul_"), 0);
+
+  EXPECT_EQ(PathValidator::Check(path, "a\\CON"),
+      PathValidator::kReservedName);
+  EXPECT_EQ(PathValidator::Check(path, "a/nul.txt"),
+      PathValidator::kReservedName);
+  EXPECT_EQ(PathValidator::Check(path, "Aux .tar.gz\\b"),
+      PathValidator::kReservedName);
+  EXPECT_EQ(PathValidator::Check(path, "com1"), PathValidator::kReservedName);
+  EXPECT_EQ(PathValidator::Check(path, "LPT9.log"),
+      PathValidator::kReservedName);
+  EXPECT_EQ(PathValidator::Check(path, "com\xc2\xb9"),
+      PathValidator::kReservedName);
+  EXPECT_EQ(PathValidator::Check(path, "a\\conin$"),
+      PathValidator::kReservedName);
+  EXPECT_EQ(PathValidator::Check(path, "CONOUT$.txt"),
+      PathValidator::kReservedName);
+  EXPECT_EQ(PathValidator::Check(path, "conin\\conout$x"), 0);
+
+  // Only the root may contain a ':'.
+  EXPECT_EQ(PathValidator::Check(path, "D:\\a"), 0);
+  EXPECT_EQ(PathValidator::Check(path, "D:evil\\a"), PathValidator::kColon);
+  EXPECT_EQ(PathValidator::Check(path, "a\\name:stream"),
+      PathValidator::kColon);
+  EXPECT_EQ(PathValidator::Check(path, "a\\b.txt::$DATA"),
+      PathValidator::kColon);
+  EXPECT_EQ(PathValidator::Check(Path::kPosix, "a/b:c"), 0);
+
+  EXPECT_EQ(PathValidator::Check(path, "a.\\b"),
+      PathValidator::kTrailingDotOrSpace);
+  EXPECT_EQ(PathValidator::Check(path, "a\\b "),
+      PathValidator::kTrailingDotOrSpace);
+  EXPECT_EQ(PathValidator::Check(path, "a\\...\\b"),
+      PathValidator::kTrailingDotOrSpace);
+  EXPECT_EQ(PathValidator::Check(path, "prn.\\a\x01"),
+      PathValidator::kReservedName | PathValidator::kTrailingDotOrSpace |
+      PathValidator::kControlCharacter);
+}
+
+void PathValidatorIsSafeTests() {
+  const Path& path = Path::kWindows;
+  EXPECT(PathValidator::IsSafe(path, "C:\\pkg", "lib\\a.dart"));
+  EXPECT(!PathValidator::IsSafe(path, "C:\\pkg", "..\\a.dart"));
+  EXPECT(!PathValidator::IsSafe(path, "C:\\pkg", "lib\\aux.dart"));
+  EXPECT(!PathValidator::IsSafe(path, "C:\\pkg", "D:\\a.dart"));
+  EXPECT(!PathValidator::IsSafe(path, "C:\\pkg", "D:a.dart"));
+  EXPECT(!PathValidator::IsSafe(path, "C:\\pkg", "lib\\a.dart:stream"));
+  EXPECT(PathValidator::IsSafe(Path::kPosix, "/pkg", "lib/aux.dart"));
+}
+
+extern void ExecutePathValidatorTests() {
+  PathValidatorControlTests();
+  PathValidatorWindowsTests();
+  PathValidatorIsSafeTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
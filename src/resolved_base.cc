@@ -0,0 +1,107 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/resolved_base.h"
+
+#include "native/platform/assert.h"
+
+namespace dart {
+namespace snapshotter {
+
+ResolvedBase::ResolvedBase(const Path& path, const std::string& base)
+    : path_(path),
+      style_(path.style()),
+      normalized_(path.Normalize(base)),
+      root_length_(style_.RootLength(normalized_)),
+      root_needs_separator_(false),
+      is_absolute_and_not_root_relative_(false),
+      leading_doubles_(0) {
+  if (root_length_ > 0) {
+    root_needs_separator_ =
+        style_.NeedsSeparator(normalized_.data(), root_length_);
+    is_absolute_and_not_root_relative_ = !style_.IsRootRelative(normalized_);
+  }
+  if (root_length_ > 0 || normalized_ != ".") base_ = normalized_;
+
+  PathComponentIterator it(style_, base_.data(), base_.length());
+  while (it.Next()) {
+    const char* component = it.component();
+    if (it.component_length() == 2 && component[0] == '.' &&
+        component[1] == '.') {
+      leading_doubles_++;
+    }
+    offsets_.push_back(offsets_.empty() ?
+        root_length_ : it.component_start() - 1);
+  }
+}
+
+void ResolvedBase::Resolve(const char* input,
+                           size_t length,
+                           std::string* result) const {
+  size_t position = 0;
+  size_t depth = offsets_.size();
+  if (length == 0) {
+    *result = normalized_;
+    return;
+  }
+  if (is_absolute_and_not_root_relative_ &&
+      style_.IsRootRelative(input, length)) {
+    // A root-relative input keeps the root of the base.
+    depth = 0;
+    position = 1;
+  } else if (style_.RootLength(input, length) > 0) {
+    // An absolute input replaces the base altogether.
+    *result = path_.Normalize(std::string(input, length));
+    return;
+  }
+  result->assign(base_, 0, BaseLength(depth));
+
+  // Components appended after the kept part of the base. The first
+  // |pinned| of them are ".." that can't be popped.
+  size_t appended = 0;
+  size_t pinned = 0;
+  char separator = style_.separator();
+  while (position <= length) {
+    size_t end = position;
+    while (end < length && !style_.IsSeparator(input[end])) end++;
+    const char* component = input + position;
+    size_t component_length = end - position;
+    position = end + 1;
+
+    if (component_length == 0 ||
+        (component_length == 1 && component[0] == '.')) {
+      continue;
+    }
+    if (component_length == 2 && component[0] == '.' && component[1] == '.') {
+      if (appended > pinned) {
+        // Pop an appended component.
+        size_t cut = BaseLength(depth);
+        if (--appended > 0) cut = result->rfind(separator);
+        result->resize(cut);
+        continue;
+      }
+      if (appended == 0 && depth > leading_doubles_) {
+        // Pop a component of the base.
+        result->resize(BaseLength(--depth));
+        continue;
+      }
+      // Absolute paths can't back out past the root.
+      if (root_length_ > 0) continue;
+      pinned++;
+    }
+    if (result->length() > root_length_) {
+      result->push_back(separator);
+    } else if (root_needs_separator_) {
+      result->push_back(separator);
+    }
+    result->append(component, component_length);
+    appended++;
+  }
+
+  // If we collapsed down to nothing, do ".".
+  if (result->empty()) result->push_back('.');
+}
+
+}  // namespace snapshotter
+}  // namespace dart
@@ -0,0 +1,70 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_RESOLVED_BASE_H_
+#define SRC_NATIVE_SNAPSHOTTER_RESOLVED_BASE_H_
+
+#include <string>
+#include <vector>
+
+#include "native/platform/globals.h"
+#include "native/snapshotter/path.h"
+
+namespace dart {
+namespace snapshotter {
+
+// A base path that is parsed and normalized once, and then used to resolve
+// any number of other paths against it.
+//
+// Resolve(input) returns the same result as
+// path.Normalize(path.Join(base, input)), but only parses |input|. A
+// ResolvedBase is immutable after construction, so it can be shared between
+// threads.
+class ResolvedBase {
+ public:
+  ResolvedBase(const Path& path, const std::string& base);
+
+  // The normalized base path.
+  const std::string& base() const { return normalized_; }
+
+  std::string Resolve(const std::string& input) const {
+    std::string result;
+    Resolve(input.data(), input.length(), &result);
+    return result;
+  }
+
+  // Stores the resolved form of |input| in |result|, reusing its storage.
+  void Resolve(const char* input, size_t length, std::string* result) const;
+
+ private:
+  // Returns the length of the base when only its first |depth| components
+  // are kept.
+  size_t BaseLength(size_t depth) const {
+    return depth < offsets_.size() ? offsets_[depth] : base_.length();
+  }
+
+  const Path& path_;
+  const PathStyle& style_;
+
+  // The normalized base, and the same without the "." that stands for an
+  // empty relative path.
+  std::string normalized_;
+  std::string base_;
+
+  size_t root_length_;
+  bool root_needs_separator_;
+  bool is_absolute_and_not_root_relative_;
+
+  // The offset at which each component of the base, including the separator
+  // before it, starts in |base_|.
+  std::vector<size_t> offsets_;
+  size_t leading_doubles_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResolvedBase);
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_RESOLVED_BASE_H_
@@ -0,0 +1,71 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include <thread>
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path.h"
+#include "native/snapshotter/resolved_base.h"
+
+namespace dart {
+namespace snapshotter {
+
+static const char* kBases[] = {
+  "", ".", "..", "../..", "a", "a/b/", "a/../..", "/", "/a/./b", "C:\\a\\b",
+  "\\a", "\\\\server\\share\\a", "http://dartlang.org/a/b", "file:///a",
+  "file://", "package:foo/bar",
+};
+
+static const char* kInputs[] = {
+  "", ".", "..", "../..", "../../../x", "b", "b/../..", "./c//d/", "..\\e",
+  "/f", "/", "\\g", "D:\\h", "\\\\s\\t\\u", "http://m.org/n/../o",
+  "a/b/c/../../..",
+};
+
+static void CompareWithJoin(const Path& path) {
+  for (size_t b = 0; b < ARRAY_SIZE(kBases); b++) {
+    ResolvedBase base(path, kBases[b]);
+    EXPECT_EQ(base.base(), path.Normalize(kBases[b]));
+    for (size_t i = 0; i < ARRAY_SIZE(kInputs); i++) {
+      EXPECT_EQ(base.Resolve(kInputs[i]),
+          path.Normalize(path.Join(kBases[b], kInputs[i])));
+    }
+  }
+}
+
+void ResolvedBaseJoinTests() {
+  CompareWithJoin(Path::kPosix);
+  CompareWithJoin(Path::kWindows);
+  CompareWithJoin(Path::kUrl);
+}
+
+static void ResolveMany(const ResolvedBase* base, int* failures) {
+  std::string result;
+  for (int i = 0; i < 10000; i++) {
+    base->Resolve("lib/src/../a.dart", 17, &result);
+    if (result != "/pkg/root/lib/a.dart") (*failures)++;
+  }
+}
+
+void ResolvedBaseThreadTests() {
+  ResolvedBase base(Path::kPosix, "/pkg/./root/");
+  int failures[4] = { 0, 0, 0, 0 };
+  std::thread threads[4];
+  for (int i = 0; i < 4; i++) {
+    threads[i] = std::thread(ResolveMany, &base, &failures[i]);
+  }
+  for (int i = 0; i < 4; i++) {
+    threads[i].join();
+    EXPECT_EQ(failures[i], 0);
+  }
+}
+
+extern void ExecuteResolvedBaseTests() {
+  ResolvedBaseJoinTests();
+  ResolvedBaseThreadTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
@@ -0,0 +1,343 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/stat_batch.h"
+
+#include "native/platform/assert.h"
+#include "native/snapshotter/path_parallel.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#if defined(TARGET_OS_LINUX)
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+// IORING_OP_STATX is an enumerator, so look for a feature flag that was
+// added after it instead.
+#if defined(__NR_io_uring_setup) && defined(IORING_FEAT_FAST_POLL)
+#define STAT_BATCH_IO_URING 1
+#endif
+#endif
+
+#include <memory>
+
+namespace dart {
+namespace snapshotter {
+
+// Stat mostly waits on the disk, so a thread is worth starting for fewer
+// paths than CPU bound work would need.
+static const size_t kMinPathsPerThread = 256;
+
+// Points |(*names)[i]| at the normalized form of |paths[i]|, which is
+// either the input itself or a copy kept in |normalized|.
+static void NormalizeAll(const Path& path,
+                         const std::vector<std::string>& paths,
+                         std::vector<std::string>* normalized,
+                         std::vector<const char*>* names) {
+  normalized->resize(paths.size());
+  names->resize(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    if (path.IsNormalized(paths[i])) {
+      (*names)[i] = paths[i].c_str();
+    } else {
+      (*normalized)[i] = path.Normalize(paths[i]);
+      (*names)[i] = (*normalized)[i].c_str();
+    }
+  }
+}
+
+static void StatOne(const char* name, StatResult* result) {
+  memset(result, 0, sizeof(*result));
+#if defined(TARGET_OS_WINDOWS)
+  struct _stat64 st;
+  if (_stat64(name, &st) != 0) {
+    result->error = errno;
+    return;
+  }
+  result->is_directory = (st.st_mode & _S_IFDIR) != 0;
+  result->modified = static_cast<int64_t>(st.st_mtime) * 1000000000;
+#else
+  struct stat st;
+  if (stat(name, &st) != 0) {
+    result->error = errno;
+    return;
+  }
+  result->is_directory = S_ISDIR(st.st_mode);
+#if defined(TARGET_OS_MACOS)
+  result->modified = static_cast<int64_t>(st.st_mtimespec.tv_sec) *
+      1000000000 + st.st_mtimespec.tv_nsec;
+#else
+  result->modified = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 +
+      st.st_mtim.tv_nsec;
+#endif
+#endif
+  result->size = st.st_size;
+}
+
+void StatBatch::StatWithThreads(const Path& path,
+                                const std::vector<std::string>& paths,
+                                std::vector<StatResult>* results,
+                                int num_threads) {
+  std::vector<std::string> normalized;
+  std::vector<const char*> names;
+  NormalizeAll(path, paths, &normalized, &names);
+  results->resize(paths.size());
+
+  size_t num_chunks =
+      PathParallel::NumChunks(paths.size(), kMinPathsPerThread, num_threads);
+  PathParallel::ForEachChunk(paths.size(), num_chunks,
+                             [&](size_t chunk, size_t start, size_t end) {
+    for (size_t i = start; i < end; i++) {
+      StatOne(names[i], &(*results)[i]);
+    }
+  });
+}
+
+#if defined(STAT_BATCH_IO_URING)
+
+// The most requests in flight at once.
+static const unsigned kRingEntries = 256;
+
+// A submission and completion queue pair, set up through the raw system
+// calls so that liburing is not needed.
+class IoUring {
+ public:
+  IoUring()
+      : fd_(-1),
+        entries_(0),
+        queued_(0),
+        sq_ring_(MAP_FAILED),
+        cq_ring_(MAP_FAILED),
+        sqes_(MAP_FAILED),
+        sq_ring_length_(0),
+        cq_ring_length_(0),
+        sqes_length_(0) {}
+
+  ~IoUring() {
+    if (sqes_ != MAP_FAILED) munmap(sqes_, sqes_length_);
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_length_);
+    }
+    if (sq_ring_ != MAP_FAILED) munmap(sq_ring_, sq_ring_length_);
+    if (fd_ >= 0) close(fd_);
+  }
+
+  // Returns false if the kernel does not support io_uring, or it is
+  // disabled.
+  bool Init(unsigned entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (fd_ < 0) return false;
+    entries_ = params.sq_entries;
+
+    sq_ring_length_ = params.sq_off.array + entries_ * sizeof(unsigned);
+    cq_ring_length_ =
+        params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap && cq_ring_length_ > sq_ring_length_) {
+      sq_ring_length_ = cq_ring_length_;
+    }
+    sq_ring_ = mmap(NULL, sq_ring_length_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) return false;
+    if (single_mmap) {
+      cq_ring_ = sq_ring_;
+    } else {
+      cq_ring_ = mmap(NULL, cq_ring_length_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+      if (cq_ring_ == MAP_FAILED) return false;
+    }
+    sqes_length_ = entries_ * sizeof(struct io_uring_sqe);
+    sqes_ = mmap(NULL, sqes_length_, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+    if (sqes_ == MAP_FAILED) return false;
+
+    char* sq = static_cast<char*>(sq_ring_);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    char* cq = static_cast<char*>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+    return true;
+  }
+
+  unsigned entries() const { return entries_; }
+
+  // Queues a statx of |name| into |buffer|, tagged with |tag|. There must
+  // be fewer than entries() requests queued or in flight.
+  void QueueStatx(const char* name, struct statx* buffer, uint64_t tag) {
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & sq_mask_;
+    struct io_uring_sqe* sqe = static_cast<struct io_uring_sqe*>(sqes_) +
+        index;
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_STATX;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = reinterpret_cast<uint64_t>(name);
+    sqe->len = STATX_TYPE | STATX_SIZE | STATX_MTIME;
+    sqe->off = reinterpret_cast<uint64_t>(buffer);
+    sqe->user_data = tag;
+    sq_array_[index] = index;
+    // Publish the entry before the kernel can see the new tail.
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    queued_++;
+  }
+
+  // Submits the queued requests and waits for at least one completion.
+  // Returns false if the ring failed.
+  bool SubmitAndWait() {
+    while (true) {
+      long submitted = syscall(__NR_io_uring_enter, fd_, queued_, 1,
+                               IORING_ENTER_GETEVENTS, NULL, 0);
+      if (submitted >= 0) {
+        queued_ -= static_cast<unsigned>(submitted);
+        return true;
+      }
+      if (errno != EINTR && errno != EAGAIN && errno != EBUSY) return false;
+    }
+  }
+
+  // Takes the next completion, if any, and stores its tag and result.
+  bool NextCompletion(uint64_t* tag, int* res) {
+    unsigned head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) return false;
+    const struct io_uring_cqe& cqe = cqes_[head & cq_mask_];
+    *tag = cqe.user_data;
+    *res = cqe.res;
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+ private:
+  int fd_;
+  unsigned entries_;
+  unsigned queued_;
+  void* sq_ring_;
+  void* cq_ring_;
+  void* sqes_;
+  size_t sq_ring_length_;
+  size_t cq_ring_length_;
+  size_t sqes_length_;
+  unsigned* sq_tail_;
+  unsigned sq_mask_;
+  unsigned* sq_array_;
+  unsigned* cq_head_;
+  unsigned* cq_tail_;
+  unsigned cq_mask_;
+  struct io_uring_cqe* cqes_;
+
+  DISALLOW_COPY_AND_ASSIGN(IoUring);
+};
+
+// What a request in flight uses. The kernel may read the name and write
+// the buffer until the request completes.
+struct StatSlot {
+  std::string name;
+  struct statx buffer;
+  size_t owner;
+};
+
+// A ring and the slots of its requests, which have to stay alive for as
+// long as any request is in flight.
+struct StatRing {
+  IoUring ring;
+  std::vector<StatSlot> slots;
+};
+
+bool StatBatch::StatWithIoUring(const Path& path,
+                                const std::vector<std::string>& paths,
+                                std::vector<StatResult>* results) {
+  std::unique_ptr<StatRing> state(new StatRing());
+  IoUring& ring = state->ring;
+  if (!ring.Init(kRingEntries)) return false;
+  std::vector<std::string> normalized;
+  std::vector<const char*> names;
+  NormalizeAll(path, paths, &normalized, &names);
+  results->resize(paths.size());
+
+  // Requests are tagged with the index of their slot.
+  std::vector<StatSlot>& slots = state->slots;
+  slots.resize(ring.entries());
+  std::vector<unsigned> free_slots;
+  for (unsigned i = ring.entries(); i > 0; i--) free_slots.push_back(i - 1);
+  std::vector<bool> finished(paths.size(), false);
+
+  size_t next = 0;
+  size_t done = 0;
+  while (done < paths.size()) {
+    while (next < paths.size() && !free_slots.empty()) {
+      StatSlot& slot = slots[free_slots.back()];
+      slot.name.assign(names[next]);
+      slot.owner = next;
+      ring.QueueStatx(slot.name.c_str(), &slot.buffer, free_slots.back());
+      free_slots.pop_back();
+      next++;
+    }
+    if (!ring.SubmitAndWait()) {
+      // The ring is broken, but requests may still be in flight, so leak
+      // it with their slots rather than free memory the kernel may use.
+      // Stat whatever has not finished synchronously.
+      state.release();
+      for (size_t i = 0; i < paths.size(); i++) {
+        if (!finished[i]) StatOne(names[i], &(*results)[i]);
+      }
+      return true;
+    }
+    uint64_t tag;
+    int res;
+    while (ring.NextCompletion(&tag, &res)) {
+      const StatSlot& slot = slots[tag];
+      size_t index = slot.owner;
+      StatResult* result = &(*results)[index];
+      if (res == -EINVAL || res == -EOPNOTSUPP) {
+        // The kernel has io_uring, but predates IORING_OP_STATX.
+        StatOne(names[index], result);
+      } else if (res < 0) {
+        memset(result, 0, sizeof(*result));
+        result->error = -res;
+      } else {
+        const struct statx& st = slot.buffer;
+        result->error = 0;
+        result->is_directory = S_ISDIR(st.stx_mode);
+        result->size = st.stx_size;
+        result->modified = static_cast<int64_t>(st.stx_mtime.tv_sec) *
+            1000000000 + st.stx_mtime.tv_nsec;
+      }
+      finished[index] = true;
+      free_slots.push_back(static_cast<unsigned>(tag));
+      done++;
+    }
+  }
+  return true;
+}
+
+#else
+
+bool StatBatch::StatWithIoUring(const Path& path,
+                                const std::vector<std::string>& paths,
+                                std::vector<StatResult>* results) {
+  return false;
+}
+
+#endif  // defined(STAT_BATCH_IO_URING)
+
+void StatBatch::Stat(const Path& path,
+                     const std::vector<std::string>& paths,
+                     std::vector<StatResult>* results,
+                     int num_threads) {
+  if (StatWithIoUring(path, paths, results)) return;
+  StatWithThreads(path, paths, results, num_threads);
+}
+
+}  // namespace snapshotter
+}  // namespace dart
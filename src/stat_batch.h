@@ -0,0 +1,62 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_STAT_BATCH_H_
+#define SRC_NATIVE_SNAPSHOTTER_STAT_BATCH_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "native/platform/globals.h"
+#include "native/snapshotter/path.h"
+
+namespace dart {
+namespace snapshotter {
+
+// What stat reported for one path.
+struct StatResult {
+  // Zero, or the errno that stat failed with, like ENOENT for a missing
+  // file. The other fields are only set when this is zero.
+  int error;
+  bool is_directory;
+  uint64_t size;
+  // The last modification time, in nanoseconds since the epoch.
+  int64_t modified;
+};
+
+// Stats many paths at once, keeping the disk and cores busy instead of
+// issuing one synchronous stat at a time.
+class StatBatch {
+ public:
+  // Stats the normalized form of each of |paths|, following symbolic links,
+  // and stores the result for |paths[i]| in |(*results)[i]|. Uses io_uring
+  // when the kernel supports it, and otherwise |num_threads| threads
+  // issuing stat calls, or one per core if |num_threads| is zero.
+  static void Stat(const Path& path,
+                   const std::vector<std::string>& paths,
+                   std::vector<StatResult>* results,
+                   int num_threads = 0);
+
+  // Like Stat, but only through io_uring. Returns false, without touching
+  // |results|, if io_uring is not available.
+  static bool StatWithIoUring(const Path& path,
+                              const std::vector<std::string>& paths,
+                              std::vector<StatResult>* results);
+
+  // Like Stat, but only through a pool of threads.
+  static void StatWithThreads(const Path& path,
+                              const std::vector<std::string>& paths,
+                              std::vector<StatResult>* results,
+                              int num_threads = 0);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(StatBatch);
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_STAT_BATCH_H_
@@ -0,0 +1,88 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path.h"
+#include "native/snapshotter/stat_batch.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace dart {
+namespace snapshotter {
+
+static void ExpectSameResults(const std::vector<StatResult>& a,
+                              const std::vector<StatResult>& b) {
+  EXPECT_EQ(a.size(), b.size());
+  for (size_t i = 0; i < a.size() && i < b.size(); i++) {
+    EXPECT_EQ(a[i].error, b[i].error);
+    EXPECT_EQ(a[i].is_directory, b[i].is_directory);
+    EXPECT_EQ(a[i].size, b[i].size);
+    EXPECT_EQ(a[i].modified, b[i].modified);
+  }
+}
+
+void StatBatchTests() {
+  char dir[] = "/tmp/stat_batch_test_XXXXXX";
+  EXPECT(mkdtemp(dir) != NULL);
+  std::string base = dir;
+  std::string file = base + "/file.dart";
+  FILE* out = fopen(file.c_str(), "wb");
+  EXPECT(out != NULL);
+  fputs("main() {}\n", out);
+  fclose(out);
+
+  std::vector<std::string> paths;
+  paths.push_back(file);
+  paths.push_back(base + "/missing");
+  paths.push_back(base);
+  paths.push_back(base + "//sub/.././file.dart");
+  paths.push_back(file + "/inside");
+
+  std::vector<StatResult> results;
+  StatBatch::Stat(Path::kPosix, paths, &results);
+  EXPECT_EQ(results.size(), 5u);
+  EXPECT_EQ(results[0].error, 0);
+  EXPECT(!results[0].is_directory);
+  EXPECT_EQ(results[0].size, 10u);
+  EXPECT(results[0].modified > 0);
+  EXPECT_EQ(results[1].error, ENOENT);
+  EXPECT_EQ(results[2].error, 0);
+  EXPECT(results[2].is_directory);
+  // Normalized before statting, so the missing "sub" does not matter.
+  EXPECT_EQ(results[3].error, 0);
+  EXPECT_EQ(results[3].size, 10u);
+  EXPECT_EQ(results[4].error, ENOTDIR);
+
+  // Both backends agree, in order, across many requests and threads.
+  std::vector<std::string> many;
+  for (int i = 0; i < 3000; i++) many.push_back(paths[i % paths.size()]);
+  std::vector<StatResult> threaded;
+  StatBatch::StatWithThreads(Path::kPosix, many, &threaded, 4);
+  EXPECT_EQ(threaded.size(), many.size());
+  for (size_t i = 0; i < many.size(); i++) {
+    EXPECT_EQ(threaded[i].error, results[i % paths.size()].error);
+  }
+  std::vector<StatResult> ring;
+  if (StatBatch::StatWithIoUring(Path::kPosix, many, &ring)) {
+    ExpectSameResults(ring, threaded);
+  }
+
+  std::vector<std::string> none;
+  StatBatch::Stat(Path::kPosix, none, &results);
+  EXPECT(results.empty());
+
+  unlink(file.c_str());
+  rmdir(dir);
+}
+
+extern void ExecuteStatBatchTests() {
+  StatBatchTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
@@ -0,0 +1,17 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/static_path.h"
+
+#include "native/platform/assert.h"
+
+namespace dart {
+namespace snapshotter {
+
+void FixedPathStringOverflow() {
+  FATAL("FixedPathString capacity exceeded");
+}
+
+}  // namespace snapshotter
+}  // namespace dart
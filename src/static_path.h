@@ -0,0 +1,323 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_STATIC_PATH_H_
+#define SRC_NATIVE_SNAPSHOTTER_STATIC_PATH_H_
+
+#include <string>
+
+#include "native/platform/globals.h"
+
+// Constant-expression versions of Path::Normalize, Path::Join and
+// Path::Dirname for the Posix and URL styles, so that well-known paths can
+// be computed and checked at compile time:
+//
+//   constexpr auto kLib = StaticPosixPath::Normalize("/sdk/./lib/../lib");
+//   static_assert(kLib == "/sdk/lib", "");
+//
+// The results match the runtime Path functions of the same style exactly.
+// The functions loop, so they need C++14 constexpr.
+
+namespace dart {
+namespace snapshotter {
+
+// Reports a result that does not fit its FixedPathString. Not constexpr, so
+// reaching it during constant evaluation is a compile error.
+void FixedPathStringOverflow();
+
+// A string with a fixed capacity that can be built in constant expressions.
+template <size_t kCapacity>
+class FixedPathString {
+ public:
+  constexpr FixedPathString() : data_(), length_(0) {}
+
+  constexpr size_t length() const { return length_; }
+  constexpr bool empty() const { return length_ == 0; }
+  constexpr const char* data() const { return data_; }
+  constexpr const char* c_str() const { return data_; }
+  constexpr char operator[](size_t index) const { return data_[index]; }
+  constexpr char back() const { return data_[length_ - 1]; }
+
+  constexpr void push_back(char c) {
+    if (length_ == kCapacity) FixedPathStringOverflow();
+    data_[length_++] = c;
+  }
+
+  constexpr void append(const char* str, size_t length) {
+    for (size_t i = 0; i < length; i++) push_back(str[i]);
+  }
+
+  constexpr void resize(size_t length) {
+    while (length_ > length) data_[--length_] = 0;
+  }
+
+  std::string str() const { return std::string(data_, length_); }
+
+  constexpr bool operator==(const char* other) const {
+    for (size_t i = 0; i < length_; i++) {
+      if (other[i] != data_[i]) return false;
+    }
+    return other[length_] == 0;
+  }
+  constexpr bool operator!=(const char* other) const {
+    return !(*this == other);
+  }
+
+ private:
+  char data_[kCapacity + 1];
+  size_t length_;
+};
+
+// The root rules of the Posix style. PosixPathStyle calls these, so the
+// runtime and compile-time paths share one implementation.
+struct StaticPosixStyle {
+  static constexpr char separator() { return '/'; }
+  static constexpr bool IsSeparator(char c) { return c == '/'; }
+
+  static constexpr size_t RootLength(const char* path, size_t length) {
+    return length > 0 && path[0] == '/' ? 1 : 0;
+  }
+
+  static constexpr bool IsRootRelative(const char* path, size_t length) {
+    return false;
+  }
+
+  static constexpr bool NeedsSeparator(const char* path, size_t length) {
+    return length > 0 && !IsSeparator(path[length - 1]);
+  }
+};
+
+// The root rules of the URL style, which UrlPathStyle calls too.
+struct StaticUrlStyle {
+  static constexpr char separator() { return '/'; }
+  static constexpr bool IsSeparator(char c) { return c == '/'; }
+
+  static constexpr size_t RootLength(const char* path, size_t length) {
+    if (length == 0) return 0;
+    if (IsSeparator(path[0])) return 1;
+
+    size_t index = 0;
+    while (index < length && path[index] != '/') index++;
+    if (index < length && path[index - 1] == ':' &&
+        index + 1 < length && path[index + 1] == '/') {
+      // The root part is up until the next '/', or the full path.
+      for (index += 2; index < length; index++) {
+        if (path[index] == '/') return index;
+      }
+      return length;
+    }
+    for (index = 0; index < length; index++) {
+      if (path[index] == ':') return index + 1;
+      char c = path[index];
+      if (!((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'))) break;
+    }
+    return 0;
+  }
+
+  static constexpr bool IsRootRelative(const char* path, size_t length) {
+    return length > 0 && IsSeparator(path[0]);
+  }
+
+  static constexpr bool NeedsSeparator(const char* path, size_t length) {
+    if (length == 0) return false;
+    if (!IsSeparator(path[length - 1])) return true;
+    // A URI that's just "scheme://" needs an extra separator.
+    return length >= 3 && path[length - 3] == ':' &&
+        path[length - 2] == '/' && RootLength(path, length) == length;
+  }
+};
+
+template <typename Style>
+class StaticPath {
+ public:
+  template <size_t kCapacity>
+  static constexpr void Normalize(const char* path,
+                                  size_t length,
+                                  FixedPathString<kCapacity>* result) {
+    size_t root_length = Style::RootLength(path, length);
+    bool is_absolute = root_length > 0;
+    result->append(path, root_length);
+
+    // The result doubles as the stack of components. |leading_doubles|
+    // counts the ".." components that could not be popped, and which are
+    // always at the front.
+    size_t base = result->length();
+    size_t num_parts = 0;
+    size_t leading_doubles = 0;
+    size_t start = root_length;
+    while (start < length) {
+      size_t end = start;
+      while (end < length && !Style::IsSeparator(path[end])) end++;
+      size_t part_length = end - start;
+      const char* part = path + start;
+      start = end + 1;
+
+      if (part_length == 0 || (part_length == 1 && part[0] == '.')) continue;
+      if (part_length == 2 && part[0] == '.' && part[1] == '.') {
+        if (num_parts > leading_doubles) {
+          // Pop the last part off.
+          size_t cut = result->length();
+          while (cut > base && !Style::IsSeparator((*result)[cut - 1])) cut--;
+          if (--num_parts == 0) {
+            cut = base;
+          } else {
+            cut--;
+          }
+          result->resize(cut);
+          continue;
+        }
+        // Backed out past the beginning. Absolute paths drop the "..".
+        if (is_absolute) continue;
+        leading_doubles++;
+      }
+      if (num_parts > 0) {
+        result->push_back(Style::separator());
+      } else if (is_absolute && Style::NeedsSeparator(path, root_length)) {
+        result->push_back(Style::separator());
+      }
+      result->append(part, part_length);
+      num_parts++;
+    }
+
+    // If we collapsed down to nothing, do ".".
+    if (result->empty()) result->push_back('.');
+  }
+
+  template <size_t kCapacity>
+  static constexpr void Dirname(const char* path,
+                                size_t length,
+                                FixedPathString<kCapacity>* result) {
+    size_t root_length = Style::RootLength(path, length);
+    size_t end = length;
+    while (end > root_length && Style::IsSeparator(path[end - 1])) end--;
+    size_t cut = end;
+    while (cut > root_length && !Style::IsSeparator(path[cut - 1])) cut--;
+    if (cut == root_length) {
+      if (root_length == 0) {
+        result->push_back('.');
+      } else {
+        result->append(path, root_length);
+      }
+      return;
+    }
+    while (cut > root_length && Style::IsSeparator(path[cut - 1])) cut--;
+    result->append(path, cut);
+  }
+
+  template <size_t kCapacity>
+  static constexpr void JoinAll(const char* const* parts,
+                                const size_t* lengths,
+                                size_t count,
+                                FixedPathString<kCapacity>* result) {
+    bool needs_separator = false;
+    bool is_absolute_and_not_root_relative = false;
+    for (size_t i = 0; i < count; i++) {
+      const char* part = parts[i];
+      size_t length = lengths[i];
+      if (length == 0) continue;
+
+      size_t root_length = Style::RootLength(part, length);
+      if (Style::IsRootRelative(part, length) &&
+          is_absolute_and_not_root_relative) {
+        // If the new part is root-relative, it preserves the previous root
+        // but replaces the path after it.
+        result->resize(Style::RootLength(result->data(), result->length()));
+        bool has_separator = length > 1 && Style::IsSeparator(part[1]);
+        if (!has_separator &&
+            Style::NeedsSeparator(result->data(), result->length())) {
+          result->push_back(Style::separator());
+        }
+        result->append(part + 1, length - 1);
+      } else if (root_length != 0) {
+        // An absolute path discards everything before it.
+        is_absolute_and_not_root_relative =
+            !Style::IsRootRelative(part, length);
+        result->resize(0);
+        result->append(part, length);
+      } else {
+        if (!Style::IsSeparator(part[0]) && needs_separator) {
+          result->push_back(Style::separator());
+        }
+        result->append(part, length);
+      }
+      // Unless this part ends with a separator, we'll need to add one before
+      // the next part.
+      needs_separator = Style::NeedsSeparator(part, length);
+    }
+  }
+
+  template <size_t N>
+  static constexpr FixedPathString<N + 1> Normalize(const char (&path)[N]) {
+    FixedPathString<N + 1> result;
+    Normalize(path, N - 1, &result);
+    return result;
+  }
+
+  template <size_t N>
+  static constexpr FixedPathString<N + 2> Normalize(
+      const FixedPathString<N>& path) {
+    FixedPathString<N + 2> result;
+    Normalize(path.data(), path.length(), &result);
+    return result;
+  }
+
+  template <size_t N>
+  static constexpr FixedPathString<N> Dirname(const char (&path)[N]) {
+    FixedPathString<N> result;
+    Dirname(path, N - 1, &result);
+    return result;
+  }
+
+  template <size_t N>
+  static constexpr FixedPathString<N + 1> Dirname(
+      const FixedPathString<N>& path) {
+    FixedPathString<N + 1> result;
+    Dirname(path.data(), path.length(), &result);
+    return result;
+  }
+
+  template <size_t N0, size_t N1>
+  static constexpr FixedPathString<N0 + N1> Join(const char (&part0)[N0],
+                                                 const char (&part1)[N1]) {
+    const char* parts[] = { part0, part1 };
+    const size_t lengths[] = { N0 - 1, N1 - 1 };
+    FixedPathString<N0 + N1> result;
+    JoinAll(parts, lengths, 2, &result);
+    return result;
+  }
+
+  template <size_t N0, size_t N1, size_t N2>
+  static constexpr FixedPathString<N0 + N1 + N2> Join(
+      const char (&part0)[N0],
+      const char (&part1)[N1],
+      const char (&part2)[N2]) {
+    const char* parts[] = { part0, part1, part2 };
+    const size_t lengths[] = { N0 - 1, N1 - 1, N2 - 1 };
+    FixedPathString<N0 + N1 + N2> result;
+    JoinAll(parts, lengths, 3, &result);
+    return result;
+  }
+
+  template <size_t N0, size_t N1>
+  static constexpr FixedPathString<N0 + N1 + 1> Join(
+      const FixedPathString<N0>& part0,
+      const char (&part1)[N1]) {
+    const char* parts[] = { part0.data(), part1 };
+    const size_t lengths[] = { part0.length(), N1 - 1 };
+    FixedPathString<N0 + N1 + 1> result;
+    JoinAll(parts, lengths, 2, &result);
+    return result;
+  }
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(StaticPath);
+};
+
+typedef StaticPath<StaticPosixStyle> StaticPosixPath;
+typedef StaticPath<StaticUrlStyle> StaticUrlPath;
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_STATIC_PATH_H_
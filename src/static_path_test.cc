@@ -0,0 +1,116 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include <string.h>
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path.h"
+#include "native/snapshotter/static_path.h"
+
+namespace dart {
+namespace snapshotter {
+
+// These are evaluated by the compiler; the test passes by compiling.
+static_assert(StaticPosixPath::Normalize("") == ".", "");
+static_assert(StaticPosixPath::Normalize("/a/./b/../c//") == "/a/c", "");
+static_assert(StaticPosixPath::Normalize("a/../../b") == "../b", "");
+static_assert(StaticPosixPath::Normalize("/../a") == "/a", "");
+static_assert(StaticPosixPath::Dirname("/a/b/") == "/a", "");
+static_assert(StaticPosixPath::Dirname("a") == ".", "");
+static_assert(StaticPosixPath::Join("a/", "b", "/c") == "/c", "");
+static_assert(StaticPosixPath::Normalize(
+    StaticPosixPath::Join("/sdk", "lib/../bin")) == "/sdk/bin", "");
+static_assert(StaticUrlPath::Normalize("file:///../a") == "file:///a", "");
+static_assert(StaticUrlPath::Normalize("http://dartlang.org/") ==
+    "http://dartlang.org", "");
+static_assert(StaticUrlPath::Join("http://dartlang.org", "a", "/b") ==
+    "http://dartlang.org/b", "");
+static_assert(StaticUrlPath::Dirname("http://dartlang.org/a") ==
+    "http://dartlang.org", "");
+
+static const char* kInputs[] = {
+  "", ".", "..", "../..", "a", "a/", "a/b", "a/b/c", "a//b///c////d",
+  "a/./b", "a/..", "a/b/..", "../a/b/..", "a/b/../../../../c", "/", "///",
+  "/.", "/..", "/../../../a", "//a", "a\\b/c", "a/b\\c/../d", "C:/", "c:/..",
+  "z/a/b/../../..\\../c", "a/b/c/../../..d/./.e/f././", "\\\\", "a:b",
+  "http://dartlang.org", "http://dartlang.org/", "http://dartlang.org/..",
+  "http://dartlang.org/../a", "http://dartlang.org//a/b/", "file://",
+  "file:///", "file:///../../a", "foo/bar://", "foo://bar/baz",
+};
+
+static void CompareWithRuntime(const Path& path, bool url) {
+  for (size_t i = 0; i < ARRAY_SIZE(kInputs); i++) {
+    std::string input = kInputs[i];
+    FixedPathString<256> normalized;
+    FixedPathString<256> dirname;
+    if (url) {
+      StaticUrlPath::Normalize(input.data(), input.length(), &normalized);
+      StaticUrlPath::Dirname(input.data(), input.length(), &dirname);
+    } else {
+      StaticPosixPath::Normalize(input.data(), input.length(), &normalized);
+      StaticPosixPath::Dirname(input.data(), input.length(), &dirname);
+    }
+    EXPECT_EQ(normalized.str(), path.Normalize(input));
+    EXPECT_EQ(dirname.str(), path.Dirname(input));
+
+    for (size_t j = 0; j < ARRAY_SIZE(kInputs); j++) {
+      const char* parts[] = { kInputs[i], kInputs[j], "c" };
+      size_t lengths[] = { input.length(), strlen(kInputs[j]), 1 };
+      FixedPathString<256> joined;
+      if (url) {
+        StaticUrlPath::JoinAll(parts, lengths, 3, &joined);
+      } else {
+        StaticPosixPath::JoinAll(parts, lengths, 3, &joined);
+      }
+      EXPECT_EQ(joined.str(), path.Join(parts[0], parts[1], parts[2]));
+    }
+  }
+}
+
+// Compares Normalize and Dirname on every string of up to six characters
+// drawn from the bytes that matter to them.
+static void CompareGeneratedWithRuntime(const Path& path, bool url) {
+  static const char kAlphabet[] = { 'a', '.', '/', ':' };
+  const size_t kMaxLength = 6;
+  std::vector<size_t> digits;
+  while (digits.size() <= kMaxLength) {
+    std::string input;
+    for (size_t i = 0; i < digits.size(); i++) {
+      input.push_back(kAlphabet[digits[i]]);
+    }
+    FixedPathString<64> normalized;
+    FixedPathString<64> dirname;
+    if (url) {
+      StaticUrlPath::Normalize(input.data(), input.length(), &normalized);
+      StaticUrlPath::Dirname(input.data(), input.length(), &dirname);
+    } else {
+      StaticPosixPath::Normalize(input.data(), input.length(), &normalized);
+      StaticPosixPath::Dirname(input.data(), input.length(), &dirname);
+    }
+    EXPECT_EQ(normalized.str(), path.Normalize(input));
+    EXPECT_EQ(dirname.str(), path.Dirname(input));
+
+    // Count up in base ARRAY_SIZE(kAlphabet), adding a digit on overflow.
+    size_t i = 0;
+    while (i < digits.size() && ++digits[i] == ARRAY_SIZE(kAlphabet)) {
+      digits[i++] = 0;
+    }
+    if (i == digits.size()) digits.push_back(0);
+  }
+}
+
+void StaticPathTests() {
+  CompareWithRuntime(Path::kPosix, false);
+  CompareWithRuntime(Path::kUrl, true);
+  CompareGeneratedWithRuntime(Path::kPosix, false);
+  CompareGeneratedWithRuntime(Path::kUrl, true);
+}
+
+extern void ExecuteStaticPathTests() {
+  StaticPathTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart
@@ -0,0 +1,194 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/snapshotter/url_reference.h"
+
+#include "native/platform/assert.h"
+
+#include <string.h>
+
+namespace dart {
+namespace snapshotter {
+
+static bool IsAlphabetic(char c) {
+  return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+static bool IsSchemeCharacter(char c) {
+  return IsAlphabetic(c) || (c >= '0' && c <= '9') ||
+      c == '+' || c == '-' || c == '.';
+}
+
+static void SetComponent(UrlReference::Component* component,
+                         const char* data,
+                         size_t length) {
+  component->data = data;
+  component->length = length;
+  component->defined = true;
+}
+
+void UrlReference::Parse(const char* url, size_t length) {
+  size_t position = 0;
+
+  // scheme ":"
+  if (length > 0 && IsAlphabetic(url[0])) {
+    size_t i = 1;
+    while (i < length && IsSchemeCharacter(url[i])) i++;
+    if (i < length && url[i] == ':') {
+      SetComponent(&scheme_, url, i);
+      position = i + 1;
+    }
+  }
+
+  // "//" authority
+  if (length - position >= 2 && url[position] == '/' &&
+      url[position + 1] == '/') {
+    size_t start = position + 2;
+    size_t end = start;
+    while (end < length && url[end] != '/' && url[end] != '?' &&
+           url[end] != '#') {
+      end++;
+    }
+    SetComponent(&authority_, url + start, end - start);
+    position = end;
+  }
+
+  // path, which is always defined but may be empty.
+  size_t end = position;
+  while (end < length && url[end] != '?' && url[end] != '#') end++;
+  SetComponent(&path_, url + position, end - position);
+  position = end;
+
+  // "?" query
+  if (position < length && url[position] == '?') {
+    end = position + 1;
+    while (end < length && url[end] != '#') end++;
+    SetComponent(&query_, url + position + 1, end - position - 1);
+    position = end;
+  }
+
+  // "#" fragment
+  if (position < length && url[position] == '#') {
+    SetComponent(&fragment_, url + position + 1, length - position - 1);
+  }
+}
+
+static bool StartsWith(const char* data, size_t length, const char* prefix) {
+  size_t prefix_length = strlen(prefix);
+  return length >= prefix_length && memcmp(data, prefix, prefix_length) == 0;
+}
+
+static bool Equals(const char* data, size_t length, const char* other) {
+  return length == strlen(other) && memcmp(data, other, length) == 0;
+}
+
+void UrlReference::RemoveDotSegments(std::string* buffer, size_t start) {
+  // The output is written over the input, which it never overtakes.
+  char* data = &(*buffer)[0];
+  size_t end = buffer->length();
+  size_t in = start;
+  size_t out = start;
+  while (in < end) {
+    const char* input = data + in;
+    size_t remaining = end - in;
+    bool pop = false;
+    if (StartsWith(input, remaining, "../")) {
+      in += 3;
+    } else if (StartsWith(input, remaining, "./")) {
+      in += 2;
+    } else if (StartsWith(input, remaining, "/./")) {
+      in += 2;
+    } else if (Equals(input, remaining, "/.")) {
+      data[out++] = '/';
+      in = end;
+    } else if (StartsWith(input, remaining, "/../")) {
+      in += 3;
+      pop = true;
+    } else if (Equals(input, remaining, "/..")) {
+      in = end;
+      pop = true;
+    } else if (Equals(input, remaining, ".") ||
+               Equals(input, remaining, "..")) {
+      in = end;
+    } else {
+      // Move the first segment, with its leading '/', to the output.
+      size_t segment_end = in + 1;
+      while (segment_end < end && data[segment_end] != '/') segment_end++;
+      memmove(data + out, input, segment_end - in);
+      out += segment_end - in;
+      in = segment_end;
+    }
+    if (pop) {
+      // Drop the last segment of the output, and the '/' before it.
+      while (out > start && data[out - 1] != '/') out--;
+      if (out > start) out--;
+      if (in == end) data[out++] = '/';
+    }
+  }
+  buffer->resize(out);
+}
+
+void UrlReference::Resolve(const UrlReference& base,
+                           const UrlReference& reference,
+                           std::string* result) {
+  result->clear();
+  result->reserve(base.scheme_.length + base.authority_.length +
+                  base.path_.length + base.query_.length +
+                  reference.path_.length + reference.query_.length +
+                  reference.fragment_.length + 8);
+
+  const Component* scheme = &base.scheme_;
+  const Component* authority = &base.authority_;
+  const Component* query = &reference.query_;
+  if (reference.scheme_.defined) {
+    scheme = &reference.scheme_;
+    authority = &reference.authority_;
+  } else if (reference.authority_.defined) {
+    authority = &reference.authority_;
+  }
+
+  if (scheme->defined) {
+    result->append(scheme->data, scheme->length);
+    result->push_back(':');
+  }
+  if (authority->defined) {
+    result->append("//");
+    result->append(authority->data, authority->length);
+  }
+
+  size_t path_start = result->length();
+  const Component& path = reference.path_;
+  if (reference.scheme_.defined || reference.authority_.defined ||
+      (path.length > 0 && path.data[0] == '/')) {
+    result->append(path.data, path.length);
+    RemoveDotSegments(result, path_start);
+  } else if (path.length == 0) {
+    result->append(base.path_.data, base.path_.length);
+    if (!query->defined) query = &base.query_;
+  } else {
+    // Merge the reference path with the directory of the base path.
+    if (base.authority_.defined && base.path_.length == 0) {
+      result->push_back('/');
+    } else {
+      size_t length = base.path_.length;
+      while (length > 0 && base.path_.data[length - 1] != '/') length--;
+      result->append(base.path_.data, length);
+    }
+    result->append(path.data, path.length);
+    RemoveDotSegments(result, path_start);
+  }
+
+  if (query->defined) {
+    result->push_back('?');
+    result->append(query->data, query->length);
+  }
+  const Component& fragment = reference.fragment_;
+  if (fragment.defined) {
+    result->push_back('#');
+    result->append(fragment.data, fragment.length);
+  }
+}
+
+}  // namespace snapshotter
+}  // namespace dart
@@ -0,0 +1,78 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef SRC_NATIVE_SNAPSHOTTER_URL_REFERENCE_H_
+#define SRC_NATIVE_SNAPSHOTTER_URL_REFERENCE_H_
+
+#include <string.h>
+
+#include <string>
+
+#include "native/platform/globals.h"
+
+namespace dart {
+namespace snapshotter {
+
+// A URI reference split into its RFC 3986 components. The components are
+// views into the parsed string, which must outlive the reference.
+//
+// Unlike UrlPathStyle, which treats everything after the authority as path,
+// this keeps "?query" and "#fragment" apart from the path so that they are
+// never treated as path segments.
+class UrlReference {
+ public:
+  struct Component {
+    Component() : data(NULL), length(0), defined(false) {}
+
+    std::string str() const { return std::string(data, length); }
+
+    const char* data;
+    size_t length;
+    bool defined;
+  };
+
+  UrlReference(const char* url, size_t length) { Parse(url, length); }
+  explicit UrlReference(const char* url) { Parse(url, strlen(url)); }
+  explicit UrlReference(const std::string& url) {
+    Parse(url.data(), url.length());
+  }
+
+  const Component& scheme() const { return scheme_; }
+  const Component& authority() const { return authority_; }
+  const Component& path() const { return path_; }
+  const Component& query() const { return query_; }
+  const Component& fragment() const { return fragment_; }
+
+  // Resolves |reference| against |base| as described in section 5.2 of
+  // RFC 3986, storing the result in |result|. Dot segments are removed in
+  // place in |result|, so the only allocation is its storage.
+  static void Resolve(const UrlReference& base,
+                      const UrlReference& reference,
+                      std::string* result);
+
+  static std::string Resolve(const std::string& base,
+                             const std::string& reference) {
+    std::string result;
+    Resolve(UrlReference(base), UrlReference(reference), &result);
+    return result;
+  }
+
+  // Removes "." and ".." segments from the path stored in
+  // (*buffer)[start..], as described in section 5.2.4 of RFC 3986.
+  static void RemoveDotSegments(std::string* buffer, size_t start);
+
+ private:
+  void Parse(const char* url, size_t length);
+
+  Component scheme_;
+  Component authority_;
+  Component path_;
+  Component query_;
+  Component fragment_;
+};
+
+}  // namespace snapshotter
+}  // namespace dart
+
+#endif  // SRC_NATIVE_SNAPSHOTTER_URL_REFERENCE_H_
@@ -0,0 +1,120 @@
+// Copyright (c) 2014, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "native/platform/globals.h"
+#include "native/platform/assert.h"
+#include "native/snapshotter/path.h"
+#include "native/snapshotter/url_reference.h"
+
+namespace dart {
+namespace snapshotter {
+
+void UrlReferenceParseTests() {
+  UrlReference url("http://dartlang.org/a/b?x=1&y#frag/../z");
+  EXPECT_EQ(url.scheme().str(), "http");
+  EXPECT_EQ(url.authority().str(), "dartlang.org");
+  EXPECT_EQ(url.path().str(), "/a/b");
+  EXPECT_EQ(url.query().str(), "x=1&y");
+  EXPECT_EQ(url.fragment().str(), "frag/../z");
+
+  UrlReference relative("../a?");
+  EXPECT(!relative.scheme().defined);
+  EXPECT(!relative.authority().defined);
+  EXPECT_EQ(relative.path().str(), "../a");
+  EXPECT(relative.query().defined);
+  EXPECT_EQ(relative.query().length, 0u);
+  EXPECT(!relative.fragment().defined);
+
+  UrlReference file("file:///a/b");
+  EXPECT(file.authority().defined);
+  EXPECT_EQ(file.authority().length, 0u);
+  EXPECT_EQ(file.path().str(), "/a/b");
+
+  UrlReference package("package:foo/foo.dart");
+  EXPECT_EQ(package.scheme().str(), "package");
+  EXPECT(!package.authority().defined);
+  EXPECT_EQ(package.path().str(), "foo/foo.dart");
+}
+
+void UrlReferenceResolveTests() {
+  // The examples from section 5.4 of RFC 3986.
+  const std::string base = "http://a/b/c/d;p?q";
+  const char* examples[][2] = {
+    { "g:h", "g:h" },
+    { "g", "http://a/b/c/g" },
+    { "./g", "http://a/b/c/g" },
+    { "g/", "http://a/b/c/g/" },
+    { "/g", "http://a/g" },
+    { "//g", "http://g" },
+    { "?y", "http://a/b/c/d;p?y" },
+    { "g?y", "http://a/b/c/g?y" },
+    { "#s", "http://a/b/c/d;p?q#s" },
+    { "g#s", "http://a/b/c/g#s" },
+    { "g?y#s", "http://a/b/c/g?y#s" },
+    { ";x", "http://a/b/c/;x" },
+    { "g;x", "http://a/b/c/g;x" },
+    { "g;x?y#s", "http://a/b/c/g;x?y#s" },
+    { "", "http://a/b/c/d;p?q" },
+    { ".", "http://a/b/c/" },
+    { "./", "http://a/b/c/" },
+    { "..", "http://a/b/" },
+    { "../", "http://a/b/" },
+    { "../g", "http://a/b/g" },
+    { "../..", "http://a/" },
+    { "../../", "http://a/" },
+    { "../../g", "http://a/g" },
+    { "../../../g", "http://a/g" },
+    { "../../../../g", "http://a/g" },
+    { "/./g", "http://a/g" },
+    { "/../g", "http://a/g" },
+    { "g.", "http://a/b/c/g." },
+    { ".g", "http://a/b/c/.g" },
+    { "g..", "http://a/b/c/g.." },
+    { "..g", "http://a/b/c/..g" },
+    { "./../g", "http://a/b/g" },
+    { "./g/.", "http://a/b/c/g/" },
+    { "g/./h", "http://a/b/c/g/h" },
+    { "g/../h", "http://a/b/c/h" },
+    { "g;x=1/./y", "http://a/b/c/g;x=1/y" },
+    { "g;x=1/../y", "http://a/b/c/y" },
+    { "g?y/./x", "http://a/b/c/g?y/./x" },
+    { "g?y/../x", "http://a/b/c/g?y/../x" },
+    { "g#s/./x", "http://a/b/c/g#s/./x" },
+    { "g#s/../x", "http://a/b/c/g#s/../x" },
+    { "http:g", "http:g" },
+  };
+  for (size_t i = 0; i < ARRAY_SIZE(examples); i++) {
+    EXPECT_EQ(UrlReference::Resolve(base, examples[i][0]), examples[i][1]);
+  }
+
+  EXPECT_EQ(UrlReference::Resolve("http://a", "b"), "http://a/b");
+  EXPECT_EQ(UrlReference::Resolve("file:///a/b/c.dart", "../d.dart"),
+      "file:///a/d.dart");
+  EXPECT_EQ(UrlReference::Resolve("package:foo/src/a.dart", "../b.dart"),
+      "package:foo/b.dart");
+
+  // The root agrees with UrlPathStyle.
+  std::string resolved =
+      UrlReference::Resolve("http://dartlang.org/a/b", "../c?d#e");
+  EXPECT_EQ(resolved, "http://dartlang.org/c?d#e");
+  EXPECT_EQ(Path::kUrl.RootPrefix(resolved), "http://dartlang.org");
+}
+
+void UrlReferenceRemoveDotSegmentsTests() {
+  std::string buffer = "prefix/a/b/c/./../../g";
+  UrlReference::RemoveDotSegments(&buffer, 6);
+  EXPECT_EQ(buffer, "prefix/a/g");
+  buffer = "mid/content=5/../6";
+  UrlReference::RemoveDotSegments(&buffer, 0);
+  EXPECT_EQ(buffer, "mid/6");
+}
+
+extern void ExecuteUrlReferenceTests() {
+  UrlReferenceParseTests();
+  UrlReferenceResolveTests();
+  UrlReferenceRemoveDotSegmentsTests();
+}
+
+}  // namespace snapshotter
+}  // namespace dart